@@ -4,22 +4,389 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <string_view>
+#include <mutex>
+#include <stdexcept>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include <set>
+#include <random>
+#include <chrono>
+#include <queue>
+#include <typeinfo>
+#include <typeindex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <csignal>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
+// 64-   (FNV-1a   )
+inline uint64_t hashBytes(string_view data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+//   :  7   ,   - " "
+inline void appendVarint(string& bytes, uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((char)value);
+}
+
+inline uint64_t readVarint(const string& bytes, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0; pos < bytes.size(); shift += 7) {
+        unsigned char byte = bytes[pos++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+//    (  FSST):  255   1..8 ,
+//       
+class SymbolTable {
+private:
+    static constexpr unsigned char ESCAPE_CODE = 255;
+    static constexpr size_t MAX_SYMBOL_LENGTH = 8;
+    static constexpr size_t MAX_SYMBOLS = 255;
+    static constexpr int TRAINING_ROUNDS = 5;
+
+    vector<string> symbols;                       //  -> 
+    vector<vector<unsigned char>> codesByFirstByte; //   -> ,    
+
+    void buildLookup() {
+        codesByFirstByte.assign(256, {});
+        for (size_t code = 0; code < symbols.size(); code++) {
+            codesByFirstByte[(unsigned char)symbols[code][0]].push_back((unsigned char)code);
+        }
+        for (auto& codes : codesByFirstByte) {
+            sort(codes.begin(), codes.end(), [this](unsigned char a, unsigned char b) {
+                return symbols[a].size() > symbols[b].size();
+            });
+        }
+    }
+
+    //       pos (-1,   )
+    int findSymbol(const char* text, size_t length, size_t pos, size_t& symbolLength) const {
+        for (unsigned char code : codesByFirstByte[(unsigned char)text[pos]]) {
+            const string& symbol = symbols[code];
+            if (symbol.size() <= length - pos && memcmp(text + pos, symbol.data(), symbol.size()) == 0) {
+                symbolLength = symbol.size();
+                return code;
+            }
+        }
+        symbolLength = 0;
+        return -1;
+    }
+
+public:
+    static shared_ptr<const SymbolTable> train(const vector<string>& sample) {
+        auto table = make_shared<SymbolTable>();
+        table->buildLookup();
+        for (int round = 0; round < TRAINING_ROUNDS; round++) {
+            //   -      
+            unordered_map<string, size_t> gain;
+            for (const string& text : sample) {
+                string previous;
+                size_t pos = 0;
+                while (pos < text.size()) {
+                    size_t symbolLength = 0;
+                    if (table->findSymbol(text.data(), text.size(), pos, symbolLength) < 0) {
+                        symbolLength = 1;
+                    }
+                    string current = text.substr(pos, symbolLength);
+                    gain[current] += current.size();
+                    if (!previous.empty() && previous.size() + current.size() <= MAX_SYMBOL_LENGTH) {
+                        gain[previous + current] += previous.size() + current.size();
+                    }
+                    previous = current;
+                    pos += symbolLength;
+                }
+            }
+            vector<pair<size_t, string>> candidates;
+            for (auto& entry : gain) {
+                candidates.emplace_back(entry.second, entry.first);
+            }
+            size_t count = min(MAX_SYMBOLS, candidates.size());
+            partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                [](const pair<size_t, string>& a, const pair<size_t, string>& b) {
+                    return a.first != b.first ? a.first > b.first : a.second < b.second;
+                });
+            table->symbols.clear();
+            for (size_t i = 0; i < count; i++) {
+                table->symbols.push_back(candidates[i].second);
+            }
+            table->buildLookup();
+        }
+        return table;
+    }
+
+    //  :     
+    string encode(const string& text) const {
+        string result;
+        result.reserve(text.size());
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t symbolLength = 0;
+            int code = findSymbol(text.data(), text.size(), pos, symbolLength);
+            if (code < 0) {
+                result.push_back((char)ESCAPE_CODE);
+                result.push_back(text[pos]);
+                pos++;
+            } else {
+                result.push_back((char)code);
+                pos += symbolLength;
+            }
+        }
+        return result;
+    }
+
+    string decode(const string& data) const {
+        string result;
+        result.reserve(data.size() * 2);
+        for (size_t i = 0; i < data.size(); i++) {
+            unsigned char code = (unsigned char)data[i];
+            if (code == ESCAPE_CODE) {
+                result.push_back(data[++i]);
+            } else {
+                result += symbols[code];
+            }
+        }
+        return result;
+    }
+
+    size_t getSymbolCount() const {
+        return symbols.size();
+    }
+};
+
+// ,    
+class CompressedString {
+private:
+    shared_ptr<const SymbolTable> table;
+    string data;
+
+public:
+    CompressedString() = default;
+
+    CompressedString(shared_ptr<const SymbolTable> symbolTable, const string& text)
+        : table(move(symbolTable)), data(table->encode(text)) {}
+
+    bool hasSameTable(const CompressedString& other) const {
+        return table == other.table;
+    }
+
+    //         
+    bool operator==(const CompressedString& other) const {
+        if (hasSameTable(other)) {
+            return data == other.data;
+        }
+        return str() == other.str();
+    }
+
+    string str() const {
+        return table ? table->decode(data) : string();
+    }
+
+    size_t compressedSize() const {
+        return data.size();
+    }
+};
+
+// ,   64      64 :
+//           .
+//    ,     
+class AlignedBytes {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+private:
+    struct FreeDeleter {
+        void operator()(char* pointer) const {
+            free(pointer);
+        }
+    };
+
+    unique_ptr<char, FreeDeleter> bytes;
+    size_t length;
+    size_t paddedLength;  //    
+
+public:
+    explicit AlignedBytes(string_view data = string_view())
+        : length(data.size()), paddedLength((max<size_t>(data.size(), 1) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT) {
+        bytes.reset(static_cast<char*>(aligned_alloc(ALIGNMENT, paddedLength)));
+        if (!bytes) {
+            throw bad_alloc();
+        }
+        if (length) {
+            memcpy(bytes.get(), data.data(), length);
+        }
+        memset(bytes.get() + length, 0, paddedLength - length);
+    }
+
+    AlignedBytes(const AlignedBytes& other) : AlignedBytes(other.view()) {}
+
+    AlignedBytes& operator=(AlignedBytes other) {
+        swap(bytes, other.bytes);
+        swap(length, other.length);
+        swap(paddedLength, other.paddedLength);
+        return *this;
+    }
+
+    const char* data() const {
+        return bytes.get();
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    size_t paddedSize() const {
+        return paddedLength;
+    }
+
+    string_view view() const {
+        return string_view(bytes.get(), length);
+    }
+
+    //       ,  
+    //   ,      
+    bool operator==(const AlignedBytes& other) const {
+        if (length != other.length) {
+            return false;
+        }
+        const char* a = bytes.get();
+        const char* b = other.bytes.get();
+#if defined(__SSE2__)
+        __m128i difference = _mm_setzero_si128();
+        for (size_t offset = 0; offset < length; offset += sizeof(__m128i)) {
+            __m128i left = _mm_load_si128(reinterpret_cast<const __m128i*>(a + offset));
+            __m128i right = _mm_load_si128(reinterpret_cast<const __m128i*>(b + offset));
+            difference = _mm_or_si128(difference, _mm_xor_si128(left, right));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) == 0xffff;
+#else
+        const uint64_t* left = reinterpret_cast<const uint64_t*>(a);
+        const uint64_t* right = reinterpret_cast<const uint64_t*>(b);
+        uint64_t difference = 0;
+        for (size_t i = 0; i * sizeof(uint64_t) < length; i++) {
+            difference |= left[i] ^ right[i];
+        }
+        return difference == 0;
+#endif
+    }
+};
+
+//   :   ,   .
+//         ExecutionLog
+class TestContext {
+private:
+    static uint64_t& currentSeed() {
+        thread_local uint64_t seed = 0;
+        return seed;
+    }
+
+public:
+    static uint64_t getSeed() {
+        return currentSeed();
+    }
+
+    static void setSeed(uint64_t seed) {
+        currentSeed() = seed;
+    }
+};
+
 //    
 class ITestRunner {
 public:
     virtual ~ITestRunner() = default;
+
     virtual bool executeTest(const string& input, const string& expected) const = 0;
+
+    //    ,      (string, mmap, ).
+    //      executeTest,     executeTest;
+    //     ,  executeTest  
+    virtual bool executeView(string_view input, string_view expected) const {
+        return executeTest(string(input), string(expected));
+    }
+
+    // true,    -   input  expected. 
+    //      (AlignedBytes, CompressedString)
+    //   ,      executeView
+    virtual bool isPureEquality() const {
+        return false;
+    }
+
+    //  ,     (< 0 -    ).
+    //     ,    
+    virtual int getComplexityLevel() const {
+        return -1;
+    }
+
+    virtual ITestRunner* clone() const = 0;
 };
 
 //   ITestRunner
 class SimpleTestRunner : public ITestRunner {
 public:
     bool executeTest(const string& input, const string& expected) const override {
+        return executeView(input, expected);
+    }
+
+    bool executeView(string_view input, string_view expected) const override {
         return input == expected;
     }
+
+    bool isPureEquality() const override {
+        return true;
+    }
+
+    SimpleTestRunner* clone() const override {
+        return new SimpleTestRunner(*this);
+    }
 };
 
 //   ITestRunner
@@ -31,9 +398,345 @@ public:
     AdvancedTestRunner(int level) : complexityLevel(level) {}
 
     bool executeTest(const string& input, const string& expected) const override {
+        return executeView(input, expected);
+    }
+
+    bool executeView(string_view input, string_view expected) const override {
         cout << "Executing with complexity level: " << complexityLevel << endl;
         return input == expected && complexityLevel > 2;
     }
+
+    AdvancedTestRunner* clone() const override {
+        return new AdvancedTestRunner(*this);
+    }
+
+    int getComplexityLevel() const override {
+        return complexityLevel;
+    }
+};
+
+//      (   )
+using OutputProducer = function<string(const string&)>;
+
+//      ()   .
+// ;        
+// (   future).   ,    
+class OracleCache {
+private:
+    static constexpr uint64_t MAGIC = 0x31454843414c524fULL;  // "ORLACHE1"
+    static constexpr size_t SHARD_COUNT = 64;
+
+    struct Shard {
+        mutex lock;
+        unordered_map<uint64_t, shared_future<string>> answers;
+    };
+
+    OutputProducer oracle;
+    string path;
+    array<Shard, SHARD_COUNT> shards;
+    atomic<size_t> computations{0};
+    atomic<size_t> hits{0};
+    atomic<bool> dirty{false};
+
+    Shard& shardFor(uint64_t key) {
+        return shards[key % SHARD_COUNT];
+    }
+
+    void load() {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return;
+        }
+        string bytes;
+        char buffer[65536];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            bytes.append(buffer, count);
+        }
+        fclose(file);
+        size_t pos = 0;
+        if (readVarint(bytes, pos) != MAGIC) {
+            throw runtime_error("Not an oracle cache: " + path);
+        }
+        while (pos + sizeof(uint64_t) <= bytes.size()) {
+            uint64_t key;
+            memcpy(&key, bytes.data() + pos, sizeof(key));
+            pos += sizeof(key);
+            size_t length = readVarint(bytes, pos);
+            if (pos + length > bytes.size()) {
+                break;  //   -    
+            }
+            promise<string> answer;
+            answer.set_value(bytes.substr(pos, length));
+            pos += length;
+            shardFor(key).answers.emplace(key, answer.get_future().share());
+        }
+    }
+
+public:
+    explicit OracleCache(OutputProducer oracleFunction, const string& cachePath = "")
+        : oracle(move(oracleFunction)), path(cachePath) {
+        if (!path.empty()) {
+            load();
+        }
+    }
+
+    ~OracleCache() {
+        try {
+            save();
+        } catch (const exception&) {
+        }
+    }
+
+    OracleCache(const OracleCache&) = delete;
+    OracleCache& operator=(const OracleCache&) = delete;
+
+    //    input;     ,
+    //   ,     
+    string get(const string& input) {
+        uint64_t key = hashBytes(input);
+        Shard& shard = shardFor(key);
+        promise<string> answer;
+        shared_future<string> result = answer.get_future().share();
+        shared_future<string> pending;
+        {
+            lock_guard<mutex> guard(shard.lock);
+            auto found = shard.answers.find(key);
+            if (found != shard.answers.end()) {
+                pending = found->second;
+            } else {
+                shard.answers.emplace(key, result);
+            }
+        }
+        //      :     
+        // ,  ,   ,     
+        if (pending.valid()) {
+            hits++;
+            return pending.get();
+        }
+        computations++;
+        try {
+            answer.set_value(oracle(input));
+        } catch (...) {
+            answer.set_exception(current_exception());
+            lock_guard<mutex> guard(shard.lock);
+            shard.answers.erase(key);
+            throw;
+        }
+        dirty = true;
+        return result.get();
+    }
+
+    size_t getComputations() const {
+        return computations;
+    }
+
+    size_t getHits() const {
+        return hits;
+    }
+
+    //          
+    void save() {
+        if (path.empty() || !dirty.exchange(false)) {
+            return;
+        }
+        string bytes;
+        appendVarint(bytes, MAGIC);
+        for (Shard& shard : shards) {
+            lock_guard<mutex> guard(shard.lock);
+            for (const auto& entry : shard.answers) {
+                if (entry.second.wait_for(chrono::seconds(0)) != future_status::ready) {
+                    continue;
+                }
+                const string& answer = entry.second.get();
+                bytes.append((const char*)&entry.first, sizeof(entry.first));
+                appendVarint(bytes, answer.size());
+                bytes += answer;
+            }
+        }
+        string temporary = path + ".tmp";
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if (!file || fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size() || fclose(file) != 0 ||
+            rename(temporary.c_str(), path.c_str()) != 0) {
+            dirty = true;
+            throw runtime_error("Cannot write oracle cache: " + path);
+        }
+    }
+};
+
+//  OracleTestRunner  :  expected -  
+//  ,    
+enum class ExpectedSource {
+    Oracle,  // expected   
+    Stored   //   expected ,   
+};
+
+//      expected:    
+//   OracleCache.     - ,
+//   SimpleTestRunner
+class OracleTestRunner : public ITestRunner {
+private:
+    shared_ptr<OracleCache> cache;
+    OutputProducer subject;
+    ExpectedSource source;
+
+public:
+    explicit OracleTestRunner(shared_ptr<OracleCache> oracleCache, OutputProducer subjectFunction = nullptr,
+                              ExpectedSource expectedSource = ExpectedSource::Oracle)
+        : cache(move(oracleCache)), subject(move(subjectFunction)), source(expectedSource) {}
+
+    bool executeTest(const string& input, const string& expected) const override {
+        return executeView(input, expected);
+    }
+
+    bool executeView(string_view input, string_view expected) const override {
+        string inputCopy(input);
+        string actual = subject ? subject(inputCopy) : inputCopy;
+        if (source == ExpectedSource::Stored) {
+            return actual == expected;
+        }
+        return actual == cache->get(inputCopy);
+    }
+
+    ExpectedSource getExpectedSource() const {
+        return source;
+    }
+
+    OracleTestRunner* clone() const override {
+        return new OracleTestRunner(*this);
+    }
+};
+
+// AdvancedTestRunner   ,   :
+//   ,     
+template <int Level>
+class StaticAdvancedTestRunner : public ITestRunner {
+public:
+    static constexpr int complexityLevel = Level;
+
+    bool executeTest(const string& input, const string& expected) const override {
+        return executeView(input, expected);
+    }
+
+    bool executeView(string_view input, string_view expected) const override {
+        if constexpr (Level > 2) {
+            return input == expected;
+        } else {
+            return false;
+        }
+    }
+
+    bool isPureEquality() const override {
+        return Level > 2;
+    }
+
+    int getComplexityLevel() const override {
+        return Level;
+    }
+
+    StaticAdvancedTestRunner* clone() const override {
+        return new StaticAdvancedTestRunner(*this);
+    }
+};
+
+//      (, , ),  
+//   SimpleTestRunner (< 0)  AdvancedTestRunner().
+//         -   
+inline int storedComplexityLevel(const ITestRunner& runner, const char* format) {
+    if (typeid(runner) == typeid(SimpleTestRunner)) {
+        return -1;
+    }
+    if (typeid(runner) == typeid(AdvancedTestRunner)) {
+        return runner.getComplexityLevel();
+    }
+    throw runtime_error(string(format) + " cannot store runner " + typeid(runner).name());
+}
+
+//   N   
+template <size_t N, size_t... I>
+bool equalUnrolled(const char* a, const char* b, index_sequence<I...>) {
+    return ((a[I] == b[I]) & ... & true);
+}
+
+template <size_t N>
+bool equalFixed(const array<char, N>& a, const array<char, N>& b) {
+    return equalUnrolled<N>(a.data(), b.data(), make_index_sequence<N>());
+}
+
+//   input/expected  ,   
+template <size_t InputLength, size_t ExpectedLength, int Level>
+class StaticTestCase {
+private:
+    array<char, InputLength> input;
+    array<char, ExpectedLength> expected;
+
+    template <size_t N, size_t... I>
+    static constexpr array<char, N> toArray(const char (&text)[N + 1], index_sequence<I...>) {
+        return {{text[I]...}};
+    }
+
+public:
+    constexpr StaticTestCase(const char (&input_str)[InputLength + 1], const char (&expected_str)[ExpectedLength + 1])
+        : input(toArray<InputLength>(input_str, make_index_sequence<InputLength>())),
+          expected(toArray<ExpectedLength>(expected_str, make_index_sequence<ExpectedLength>())) {}
+
+    bool runTest() const {
+        if constexpr (Level <= 2 || InputLength != ExpectedLength) {
+            return false;
+        } else {
+            return equalFixed(input, expected);
+        }
+    }
+
+    string_view inputView() const {
+        return string_view(input.data(), InputLength);
+    }
+
+    string_view expectedView() const {
+        return string_view(expected.data(), ExpectedLength);
+    }
+};
+
+template <int Level = 3, size_t InputSize, size_t ExpectedSize>
+constexpr StaticTestCase<InputSize - 1, ExpectedSize - 1, Level> makeStaticTest(const char (&input)[InputSize], const char (&expected)[ExpectedSize]) {
+    return StaticTestCase<InputSize - 1, ExpectedSize - 1, Level>(input, expected);
+}
+
+//  ,    :     
+template <class... Tests>
+class StaticTestSuite {
+private:
+    tuple<Tests...> tests;
+
+public:
+    constexpr StaticTestSuite(const Tests&... testCases) : tests(testCases...) {}
+
+    static constexpr size_t getTestCount() {
+        return sizeof...(Tests);
+    }
+
+    int countPassed() const {
+        return apply([](const Tests&... testCases) {
+            return (0 + ... + int(testCases.runTest()));
+        }, tests);
+    }
+
+    const tuple<Tests...>& getTests() const {
+        return tests;
+    }
+};
+
+class Fixture;
+
+//       (0 -  )
+struct ResourceLimits {
+    size_t memoryBytes = 0;
+    double cpuSeconds = 0;
+    size_t openFiles = 0;
+
+    bool isSet() const {
+        return memoryBytes || cpuSeconds > 0 || openFiles;
+    }
 };
 
 //    TestCaseBase
@@ -42,6 +745,7 @@ protected:
     string input;
     string expected;
     unique_ptr<ITestRunner> testRunner;
+    ResourceLimits limits;
 
 public:
     TestCaseBase(const string& input_str, const string& expected_str, unique_ptr<ITestRunner> runner)
@@ -53,15 +757,44 @@ public:
         return testRunner->executeTest(input, expected);
     }
 
+    //    ;     
+    virtual bool runWithFixture(const Fixture&) const {
+        return runTest();
+    }
+
     virtual TestCaseBase* clone() const = 0;
 
-    const string& getInput() const {
+    //    inputView/expectedView:     
+    // (BlobTestCase, PaddedTestCase, ImageTestCase)  input/expected 
+    string getInput() const {
+        return string(inputView());
+    }
+
+    string getExpected() const {
+        return string(expectedView());
+    }
+
+    //     ,   
+    virtual string_view inputView() const {
         return input;
     }
 
-    const string& getExpected() const {
+    virtual string_view expectedView() const {
         return expected;
     }
+
+    const ITestRunner& getRunner() const {
+        return *testRunner;
+    }
+
+    //     (ForkServer)
+    void setResourceLimits(const ResourceLimits& resourceLimits) {
+        limits = resourceLimits;
+    }
+
+    const ResourceLimits& getResourceLimits() const {
+        return limits;
+    }
 };
 
 //  TestCase -   TestCaseBase
@@ -98,70 +831,5323 @@ public:
     }
 };
 
-//  TestSuite
-class TestSuite {
+//     
+class MappedBlob {
 private:
-    vector<shared_ptr<TestCaseBase>> tests;
-    static int totalTestSuitesCreated;
+    string id;
+    void* address;
+    size_t size;
 
 public:
-    TestSuite() {
-        totalTestSuitesCreated++;
+    MappedBlob(const string& blobId, const string& path) : id(blobId), address(nullptr), size(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open blob: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            size = info.st_size;
+            address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (address == MAP_FAILED) {
+            throw runtime_error("Cannot map blob: " + path);
+        }
     }
 
-    void addTest(shared_ptr<TestCaseBase> test) {
-        tests.push_back(test);
+    MappedBlob(const MappedBlob&) = delete;
+    MappedBlob& operator=(const MappedBlob&) = delete;
+
+    ~MappedBlob() {
+        if (address) {
+            munmap(address, size);
+        }
     }
 
-    const vector<shared_ptr<TestCaseBase>>& getTests() const {
-        return tests;
+    string_view view() const {
+        return string_view(static_cast<const char*>(address), size);
     }
 
-    int getTestCount() const {
-        return tests.size();
+    const string& getId() const {
+        return id;
     }
+};
 
-    static int getTotalTestSuitesCreated() {
-        return totalTestSuitesCreated;
+//      :     ,
+//   ,          .
+//    shared_ptr:  ,   .
+//        -   sweep()  
+// ,      
+class BlobStore {
+private:
+    string directory;
+    mutable mutex lock;
+    mutable map<string, weak_ptr<const MappedBlob>> mapped;
+    mutable size_t purgeThreshold = 64;  //     mapped   
+
+    string pathFor(const string& id) const {
+        return directory + "/" + id + ".blob";
     }
 
-    void sortTestsByInput() {
-        sort(tests.begin(), tests.end(), [](const shared_ptr<TestCaseBase>& a, const shared_ptr<TestCaseBase>& b) {
-            return a->getInput() < b->getInput();
-        });
+    static string idFor(string_view data) {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long)hashBytes(data));
+        return string(name) + "-" + to_string(data.size());
     }
 
-    shared_ptr<TestCaseBase> findTestByExpected(const string& expected) const {
-        auto it = find_if(tests.begin(), tests.end(), [&expected](const shared_ptr<TestCaseBase>& test) {
-            return test->getExpected() == expected;
-        });
-        return (it != tests.end()) ? *it : nullptr;
+public:
+    explicit BlobStore(const string& dir) : directory(dir) {
+        mkdir(directory.c_str(), 0755);
     }
-};
 
-int TestSuite::totalTestSuitesCreated = 0;
+    shared_ptr<const MappedBlob> put(string_view data) const {
+        string id = idFor(data);
+        string path = pathFor(id);
+        lock_guard<mutex> guard(lock);
+        if (access(path.c_str(), F_OK) != 0) {
+            //      ,    
+            string tempPath = path + ".tmp" + to_string(getpid());
+            FILE* file = fopen(tempPath.c_str(), "wb");
+            bool written = file && fwrite(data.data(), 1, data.size(), file) == data.size();
+            written = file && fclose(file) == 0 && written;
+            if (!written || rename(tempPath.c_str(), path.c_str()) != 0) {
+                remove(tempPath.c_str());
+                throw runtime_error("Cannot write blob: " + path);
+            }
+        }
+        shared_ptr<const MappedBlob> blob = getLocked(id);
+        if (blob->view() != data) {
+            throw runtime_error("Blob hash collision: " + id);
+        }
+        return blob;
+    }
+
+    shared_ptr<const MappedBlob> get(const string& id) const {
+        lock_guard<mutex> guard(lock);
+        return getLocked(id);
+    }
+
+    long getReferenceCount(const string& id) const {
+        lock_guard<mutex> guard(lock);
+        auto it = mapped.find(id);
+        return it != mapped.end() ? it->second.use_count() : 0;
+    }
+
+    //    ,    liveIds    
+    //   ;   . liveIds  
+    //    :      
+    size_t sweep(const unordered_set<string>& liveIds) const {
+        lock_guard<mutex> guard(lock);
+        DIR* dir = opendir(directory.c_str());
+        if (!dir) {
+            throw runtime_error("Cannot list blob store: " + directory);
+        }
+        static const string suffix = ".blob";
+        vector<string> victims;
+        while (dirent* entry = readdir(dir)) {
+            string name = entry->d_name;
+            if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            string id = name.substr(0, name.size() - suffix.size());
+            auto it = mapped.find(id);
+            if (!liveIds.count(id) && (it == mapped.end() || it->second.expired())) {
+                victims.push_back(id);
+            }
+        }
+        closedir(dir);
+        size_t removed = 0;
+        for (const auto& id : victims) {
+            removed += unlink(pathFor(id).c_str()) == 0;
+            mapped.erase(id);
+        }
+        return removed;
+    }
 
-//  Task
-class Task {
 private:
-    string description;
-    TestSuite testSuite;
+    shared_ptr<const MappedBlob> getLocked(const string& id) const {
+        shared_ptr<const MappedBlob> blob = mapped[id].lock();
+        if (!blob) {
+            blob = make_shared<const MappedBlob>(id, pathFor(id));
+            mapped[id] = blob;
+            purgeExpiredLocked();
+        }
+        return blob;
+    }
+
+    //      ,     O(1)  
+    void purgeExpiredLocked() const {
+        if (mapped.size() < purgeThreshold) {
+            return;
+        }
+        for (auto it = mapped.begin(); it != mapped.end();) {
+            it = it->second.expired() ? mapped.erase(it) : next(it);
+        }
+        purgeThreshold = max<size_t>(64, 2 * mapped.size());
+    }
+};
+
+//  BlobTestCase - expected    BlobStore,     
+class BlobTestCase : public TestCaseBase {
+private:
+    shared_ptr<const MappedBlob> expectedBlob;
 
 public:
-    Task(const string& desc, const TestSuite& suite)
-        : description(desc), testSuite(suite) {}
+    BlobTestCase(const string& input_str, shared_ptr<const MappedBlob> blob, unique_ptr<ITestRunner> runner)
+        : TestCaseBase(input_str, "", move(runner)), expectedBlob(move(blob)) {}
 
-    const string& getDescription() const {
-        return description;
+    bool runTest() const override {
+        return testRunner->executeView(input, expectedBlob->view());
     }
 
-    TestSuite& getTestSuite() {
-        return testSuite;
+    string_view expectedView() const override {
+        return expectedBlob->view();
+    }
+
+    BlobTestCase* clone() const override {
+        return new BlobTestCase(input, expectedBlob, unique_ptr<ITestRunner>(testRunner->clone()));
+    }
+
+    const shared_ptr<const MappedBlob>& getExpectedBlob() const {
+        return expectedBlob;
     }
 };
 
-//  
-int main() {
+//  PaddedTestCase - input/expected    
+//  (AlignedBytes);        
+class PaddedTestCase : public TestCaseBase {
+private:
+    AlignedBytes paddedInput;
+    AlignedBytes paddedExpected;
+
+public:
+    PaddedTestCase(string_view input_bytes, string_view expected_bytes, unique_ptr<ITestRunner> runner)
+        : TestCaseBase("", "", move(runner)), paddedInput(input_bytes), paddedExpected(expected_bytes) {}
+
+    bool runTest() const override {
+        if (testRunner->isPureEquality()) {
+            return paddedInput == paddedExpected;  //   
+        }
+        return testRunner->executeView(paddedInput.view(), paddedExpected.view());
+    }
+
+    string_view inputView() const override {
+        return paddedInput.view();
+    }
+
+    string_view expectedView() const override {
+        return paddedExpected.view();
+    }
+
+    PaddedTestCase* clone() const override {
+        return new PaddedTestCase(paddedInput.view(), paddedExpected.view(), unique_ptr<ITestRunner>(testRunner->clone()));
+    }
+
+    const AlignedBytes& getPaddedInput() const {
+        return paddedInput;
+    }
+
+    const AlignedBytes& getPaddedExpected() const {
+        return paddedExpected;
+    }
+};
+
+//   ,      
+struct SuiteImageStats {
+    uint64_t caseCount;
+    uint64_t advancedCount;
+    uint64_t inputBytes;
+    uint64_t expectedBytes;
+    uint64_t maxInputLength;
+    uint64_t maxExpectedLength;
+};
+
+class ImageTestCase;
+
+//      :  , , 
+//   input, -  expected  .    -
+//    ,     mmap  
+//  ,  O(1)    .
+// : [Header][CaseEntry * n][uint32  * n][IndexSlot * buckets][]
+class SuiteImage : public enable_shared_from_this<SuiteImage> {
+private:
+    static constexpr uint64_t MAGIC = 0x314547414d495453ULL;  // "STIMAGE1"
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t fileSize;
+        uint64_t caseTableOffset;
+        uint64_t sortedOffset;
+        uint64_t indexOffset;
+        uint64_t indexBuckets;  //  
+        uint64_t arenaOffset;
+        SuiteImageStats stats;
+    };
+
+    struct CaseEntry {
+        uint64_t inputOffset;
+        uint64_t expectedOffset;
+        uint32_t inputLength;
+        uint32_t expectedLength;
+        int32_t complexityLevel;  // < 0 - SimpleTestRunner
+        uint32_t reserved;
+    };
+
+    //     ; caseNumber =  + 1, 0 - 
+    struct IndexSlot {
+        uint64_t expectedHash;
+        uint32_t caseNumber;
+        uint32_t reserved;
+    };
+
+    void* address;
+    size_t mappedSize;
+    const Header* header;
+
+    const char* base() const {
+        return static_cast<const char*>(address);
+    }
+
+    const CaseEntry& entry(size_t index) const {
+        return reinterpret_cast<const CaseEntry*>(base() + header->caseTableOffset)[index];
+    }
+
+    static uint64_t alignUp(uint64_t value) {
+        return (value + 7) & ~uint64_t(7);
+    }
+
+    //   count   size   offset  
+    bool fits(uint64_t offset, uint64_t count, uint64_t size) const {
+        return offset <= mappedSize && count <= (mappedSize - offset) / size;
+    }
+
+    //       ,    
+    const CaseEntry& checkedEntry(size_t index) const {
+        if (index >= header->stats.caseCount) {
+            throw out_of_range("Suite image case index out of range");
+        }
+        const CaseEntry& e = entry(index);
+        if (!fits(e.inputOffset, e.inputLength, 1) || !fits(e.expectedOffset, e.expectedLength, 1)) {
+            throw runtime_error("Corrupt suite image: case data out of bounds");
+        }
+        return e;
+    }
+
+public:
+    explicit SuiteImage(const string& path) : address(MAP_FAILED), mappedSize(0), header(nullptr) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open suite image: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(Header)) {
+            mappedSize = info.st_size;
+            address = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (address == MAP_FAILED) {
+            throw runtime_error("Cannot map suite image: " + path);
+        }
+        header = static_cast<const Header*>(address);
+        if (header->magic != MAGIC || header->version != VERSION || header->fileSize != mappedSize) {
+            munmap(address, mappedSize);
+            throw runtime_error("Not a suite image or truncated: " + path);
+        }
+        //       ,   O(1)
+        uint64_t count = header->stats.caseCount;
+        uint64_t buckets = header->indexBuckets;
+        bool valid = count <= UINT32_MAX && header->caseTableOffset % 8 == 0 && header->indexOffset % 8 == 0 &&
+                     header->sortedOffset % 4 == 0 && fits(header->caseTableOffset, count, sizeof(CaseEntry)) &&
+                     fits(header->sortedOffset, count, sizeof(uint32_t)) && buckets > count &&
+                     (buckets & (buckets - 1)) == 0 && fits(header->indexOffset, buckets, sizeof(IndexSlot)) &&
+                     header->arenaOffset <= mappedSize;
+        if (!valid) {
+            munmap(address, mappedSize);
+            throw runtime_error("Corrupt suite image header: " + path);
+        }
+    }
+
+    SuiteImage(const SuiteImage&) = delete;
+    SuiteImage& operator=(const SuiteImage&) = delete;
+
+    ~SuiteImage() {
+        munmap(address, mappedSize);
+    }
+
+    //    (TestCase/AdvancedTestCase     )
+    //  SimpleTestRunner  AdvancedTestRunner;    - .
+    //        path
+    static void write(const vector<shared_ptr<TestCaseBase>>& tests, const string& path) {
+        size_t count = tests.size();
+        if (count > UINT32_MAX) {
+            throw runtime_error("Suite is too large for an image");
+        }
+        uint64_t buckets = 1;
+        while (buckets < 2 * count) {
+            buckets <<= 1;
+        }
+
+        Header head = {};
+        head.magic = MAGIC;
+        head.version = VERSION;
+        head.caseTableOffset = alignUp(sizeof(Header));
+        head.sortedOffset = head.caseTableOffset + count * sizeof(CaseEntry);
+        head.indexOffset = alignUp(head.sortedOffset + count * sizeof(uint32_t));
+        head.indexBuckets = buckets;
+        head.arenaOffset = head.indexOffset + buckets * sizeof(IndexSlot);
+
+        vector<CaseEntry> entries(count);
+        vector<IndexSlot> index(buckets, IndexSlot{0, 0, 0});
+        uint64_t offset = head.arenaOffset;
+        SuiteImageStats& stats = head.stats;
+        stats.caseCount = count;
+        for (size_t i = 0; i < count; i++) {
+            string_view input = tests[i]->inputView();
+            string_view expected = tests[i]->expectedView();
+            int32_t level = storedComplexityLevel(tests[i]->getRunner(), "Suite image");
+            if (input.size() > UINT32_MAX || expected.size() > UINT32_MAX) {
+                throw runtime_error("Test data is too large for an image");
+            }
+            entries[i] = {offset, offset + input.size(), (uint32_t)input.size(), (uint32_t)expected.size(), level, 0};
+            offset += input.size() + expected.size();
+
+            uint64_t hash = hashBytes(expected);
+            size_t slot = hash & (buckets - 1);
+            while (index[slot].caseNumber != 0) {
+                slot = (slot + 1) & (buckets - 1);
+            }
+            index[slot] = {hash, (uint32_t)(i + 1), 0};
+
+            stats.advancedCount += level >= 0;
+            stats.inputBytes += input.size();
+            stats.expectedBytes += expected.size();
+            stats.maxInputLength = max<uint64_t>(stats.maxInputLength, input.size());
+            stats.maxExpectedLength = max<uint64_t>(stats.maxExpectedLength, expected.size());
+        }
+        head.fileSize = offset;
+
+        vector<uint32_t> sorted(count);
+        for (size_t i = 0; i < count; i++) {
+            sorted[i] = i;
+        }
+        stable_sort(sorted.begin(), sorted.end(), [&tests](uint32_t a, uint32_t b) {
+            return tests[a]->inputView() < tests[b]->inputView();
+        });
+
+        string temporary = path + ".tmp";
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if (!file) {
+            throw runtime_error("Cannot create suite image: " + path);
+        }
+        static const char padding[8] = {};
+        auto put = [file](const void* data, size_t size) {
+            return size == 0 || fwrite(data, 1, size, file) == size;
+        };
+        bool ok = put(&head, sizeof(head)) && put(padding, head.caseTableOffset - sizeof(head)) &&
+                  put(entries.data(), count * sizeof(CaseEntry)) && put(sorted.data(), count * sizeof(uint32_t)) &&
+                  put(padding, head.indexOffset - head.sortedOffset - count * sizeof(uint32_t)) &&
+                  put(index.data(), buckets * sizeof(IndexSlot));
+        for (size_t i = 0; ok && i < count; i++) {
+            string_view input = tests[i]->inputView();
+            string_view expected = tests[i]->expectedView();
+            ok = put(input.data(), input.size()) && put(expected.data(), expected.size());
+        }
+        ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && fclose(file) == 0 && ok;
+        if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+            remove(temporary.c_str());
+            throw runtime_error("Cannot write suite image: " + path);
+        }
+    }
+
+    size_t size() const {
+        return header->stats.caseCount;
+    }
+
+    const SuiteImageStats& getStats() const {
+        return header->stats;
+    }
+
+    string_view inputView(size_t index) const {
+        const CaseEntry& e = checkedEntry(index);
+        return string_view(base() + e.inputOffset, e.inputLength);
+    }
+
+    string_view expectedView(size_t index) const {
+        const CaseEntry& e = checkedEntry(index);
+        return string_view(base() + e.expectedOffset, e.expectedLength);
+    }
+
+    int getComplexityLevel(size_t index) const {
+        return checkedEntry(index).complexityLevel;
+    }
+
+    //  ,    rank    input
+    size_t sortedIndex(size_t rank) const {
+        if (rank >= size()) {
+            throw out_of_range("Suite image rank out of range");
+        }
+        size_t index = reinterpret_cast<const uint32_t*>(base() + header->sortedOffset)[rank];
+        if (index >= size()) {
+            throw runtime_error("Corrupt suite image: sort order out of bounds");
+        }
+        return index;
+    }
+
+    //        expected  SIZE_MAX
+    size_t findIndexByExpected(string_view expected) const {
+        const IndexSlot* index = reinterpret_cast<const IndexSlot*>(base() + header->indexOffset);
+        uint64_t mask = header->indexBuckets - 1;
+        uint64_t hash = hashBytes(expected);
+        size_t probes = 0;
+        for (size_t slot = hash & mask; index[slot].caseNumber != 0 && probes++ <= mask; slot = (slot + 1) & mask) {
+            if (index[slot].expectedHash == hash && expectedView(index[slot].caseNumber - 1) == expected) {
+                return index[slot].caseNumber - 1;
+            }
+        }
+        return SIZE_MAX;
+    }
+
+    bool runTest(size_t index) const {
+        int level = getComplexityLevel(index);
+        if (level >= 0) {
+            return AdvancedTestRunner(level).executeView(inputView(index), expectedView(index));
+        }
+        return SimpleTestRunner().executeView(inputView(index), expectedView(index));
+    }
+
+    // ,    ;  ,    
+    shared_ptr<TestCaseBase> getTest(size_t index) const;
+
+    shared_ptr<TestCaseBase> findTestByExpected(string_view expected) const {
+        size_t index = findIndexByExpected(expected);
+        return index != SIZE_MAX ? getTest(index) : nullptr;
+    }
+};
+
+//  ImageTestCase - ,      SuiteImage
+class ImageTestCase : public TestCaseBase {
+private:
+    shared_ptr<const SuiteImage> image;
+    size_t index;
+
+    static unique_ptr<ITestRunner> runnerFor(const SuiteImage& image, size_t index) {
+        int level = image.getComplexityLevel(index);
+        if (level >= 0) {
+            return make_unique<AdvancedTestRunner>(level);
+        }
+        return make_unique<SimpleTestRunner>();
+    }
+
+public:
+    ImageTestCase(shared_ptr<const SuiteImage> suiteImage, size_t caseIndex)
+        : TestCaseBase("", "", runnerFor(*suiteImage, caseIndex)), image(move(suiteImage)), index(caseIndex) {}
+
+    bool runTest() const override {
+        return testRunner->executeView(inputView(), expectedView());
+    }
+
+    string_view inputView() const override {
+        return image->inputView(index);
+    }
+
+    string_view expectedView() const override {
+        return image->expectedView(index);
+    }
+
+    ImageTestCase* clone() const override {
+        return new ImageTestCase(image, index);
+    }
+};
+
+inline shared_ptr<TestCaseBase> SuiteImage::getTest(size_t index) const {
+    return make_shared<ImageTestCase>(shared_from_this(), index);
+}
+
+//     ( ,    ..)
+class Fixture {
+public:
+    virtual ~Fixture() = default;
+    virtual void setUp() = 0;
+    virtual void tearDown() {}
+};
+
+// PerThread -      ,
+// PerProcess -    ,     
+enum class FixtureScope {
+    PerThread,
+    PerProcess
+};
+
+//  FixtureTestCase -      
+template <class FixtureType>
+class FixtureTestCase : public TestCaseBase {
+private:
+    function<string(const FixtureType&, const string&)> action;
+
+public:
+    FixtureTestCase(const string& input_str, const string& expected_str,
+                    function<string(const FixtureType&, const string&)> fixtureAction,
+                    unique_ptr<ITestRunner> runner = make_unique<SimpleTestRunner>())
+        : TestCaseBase(input_str, expected_str, move(runner)), action(move(fixtureAction)) {}
+
+    //     
+    bool runTest() const override {
+        return false;
+    }
+
+    bool runWithFixture(const Fixture& fixture) const override {
+        return testRunner->executeTest(action(static_cast<const FixtureType&>(fixture), input), expected);
+    }
+
+    FixtureTestCase* clone() const override {
+        return new FixtureTestCase(input, expected, action, unique_ptr<ITestRunner>(testRunner->clone()));
+    }
+};
+
+//     
+class FixtureGroup {
+private:
+    string name;
+    FixtureScope scope;
+    function<unique_ptr<Fixture>()> factory;
+    vector<shared_ptr<TestCaseBase>> tests;
+    ResourceLimits limits;
+
+public:
+    FixtureGroup(const string& groupName, FixtureScope fixtureScope, function<unique_ptr<Fixture>()> fixtureFactory)
+        : name(groupName), scope(fixtureScope), factory(move(fixtureFactory)) {}
+
+    void addTest(shared_ptr<TestCaseBase> test) {
+        tests.push_back(test);
+    }
+
+    //          ;  
+    //        
+    shared_ptr<FixtureGroup> withTests(vector<shared_ptr<TestCaseBase>> groupTests) const {
+        auto copy = make_shared<FixtureGroup>(*this);
+        copy->tests = move(groupTests);
+        return copy;
+    }
+
+    const vector<shared_ptr<TestCaseBase>>& getTests() const {
+        return tests;
+    }
+
+    const string& getName() const {
+        return name;
+    }
+
+    FixtureScope getScope() const {
+        return scope;
+    }
+
+    //    ,     
+    void setResourceLimits(const ResourceLimits& resourceLimits) {
+        limits = resourceLimits;
+    }
+
+    const ResourceLimits& getResourceLimits() const {
+        return limits;
+    }
+
+    //    ; nullptr,  setUp  
+    unique_ptr<Fixture> setUpFixture() const {
+        try {
+            unique_ptr<Fixture> fixture = factory();
+            if (!fixture) {
+                throw runtime_error("fixture factory returned null");
+            }
+            fixture->setUp();
+            return fixture;
+        } catch (const exception& e) {
+            cerr << "Fixture setup failed for group " << name << ": " << e.what() << endl;
+            return nullptr;
+        }
+    }
+};
+
+//   . -   
+//     varint,    
+class TrigramIndex {
+private:
+    struct PostingList {
+        string bytes;
+        uint32_t last = 0;
+        size_t count = 0;
+    };
+
+    unordered_map<uint32_t, PostingList> postings;
+
+    static void appendDocument(PostingList& list, uint32_t document) {
+        appendVarint(list.bytes, list.count ? document - list.last : document);
+        list.last = document;
+        list.count++;
+    }
+
+    static vector<uint32_t> decode(const PostingList& list) {
+        vector<uint32_t> documents;
+        documents.reserve(list.count);
+        uint32_t document = 0;
+        for (size_t pos = 0; pos < list.bytes.size();) {
+            document += readVarint(list.bytes, pos);
+            documents.push_back(document);
+        }
+        return documents;
+    }
+
+    static vector<uint32_t> trigramsOf(string_view text) {
+        vector<uint32_t> trigrams;
+        for (size_t i = 0; i + 3 <= text.size(); i++) {
+            trigrams.push_back((uint32_t)(unsigned char)text[i] << 16 | (uint32_t)(unsigned char)text[i + 1] << 8 |
+                               (unsigned char)text[i + 2]);
+        }
+        sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+    //      :  
+    // ,     
+    void append(const TrigramIndex& other) {
+        for (const auto& entry : other.postings) {
+            const PostingList& source = entry.second;
+            PostingList& target = postings[entry.first];
+            size_t pos = 0;
+            appendDocument(target, (uint32_t)readVarint(source.bytes, pos));
+            target.bytes.append(source.bytes, pos, string::npos);
+            target.last = source.last;
+            target.count += source.count - 1;
+        }
+    }
+
+public:
+    void add(uint32_t document, string_view text) {
+        for (uint32_t trigram : trigramsOf(text)) {
+            appendDocument(postings[trigram], document);
+        }
+    }
+
+    //  0..texts.size()-1;      
+    static TrigramIndex build(const vector<string_view>& texts, unsigned threadCount) {
+        threadCount = max(1u, min<unsigned>(threadCount, texts.size() / 1024 + 1));
+        vector<TrigramIndex> parts(threadCount);
+        vector<thread> threads;
+        size_t step = (texts.size() + threadCount - 1) / threadCount;
+        for (unsigned t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = t * step; i < min(texts.size(), (t + 1) * step); i++) {
+                    parts[t].add(i, texts[i]);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        TrigramIndex index = move(parts[0]);
+        for (unsigned t = 1; t < threadCount; t++) {
+            index.append(parts[t]);
+        }
+        return index;
+    }
+
+    // ,     ( :  )
+    vector<uint32_t> candidates(string_view pattern) const {
+        vector<const PostingList*> lists;
+        for (uint32_t trigram : trigramsOf(pattern)) {
+            auto it = postings.find(trigram);
+            if (it == postings.end()) {
+                return {};
+            }
+            lists.push_back(&it->second);
+        }
+        sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) {
+            return a->count < b->count;
+        });
+        vector<uint32_t> result = decode(*lists[0]);
+        for (size_t i = 1; i < lists.size() && !result.empty(); i++) {
+            vector<uint32_t> next = decode(*lists[i]);
+            vector<uint32_t> both;
+            set_intersection(result.begin(), result.end(), next.begin(), next.end(), back_inserter(both));
+            result.swap(both);
+        }
+        return result;
+    }
+
+    size_t getCompressedSize() const {
+        size_t total = 0;
+        for (const auto& entry : postings) {
+            total += entry.second.bytes.size();
+        }
+        return total;
+    }
+};
+
+//  :     ,   ,
+//     .      (varint,
+//   )     (TestSuite::replay)
+class ExecutionLog {
+public:
+    struct Entry {
+        uint32_t worker;
+        uint32_t testIndex;  //   TestSuite::getSchedule()
+        uint64_t sequence;   //   
+        uint64_t seed;
+        int64_t startNanos;  //   
+        int64_t endNanos;
+    };
+
+private:
+    static constexpr uint64_t MAGIC = 0x31474f4c43455845ULL;  // "EXECLOG1"
+
+    uint64_t runSeed;
+    mutable mutex lock;
+    vector<Entry> entries;
+    chrono::steady_clock::time_point origin;
+
+    static uint64_t zigzag(int64_t value) {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value) {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+public:
+    explicit ExecutionLog(uint64_t seed = random_device{}()) : runSeed(seed), origin(chrono::steady_clock::now()) {}
+
+    //  ,  save()
+    explicit ExecutionLog(const string& path) : runSeed(0), origin(chrono::steady_clock::now()) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            throw runtime_error("Cannot open execution log: " + path);
+        }
+        string bytes;
+        char buffer[65536];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            bytes.append(buffer, count);
+        }
+        fclose(file);
+        size_t pos = 0;
+        if (readVarint(bytes, pos) != MAGIC) {
+            throw runtime_error("Not an execution log: " + path);
+        }
+        runSeed = readVarint(bytes, pos);
+        size_t total = readVarint(bytes, pos);
+        Entry previous = {0, 0, 0, 0, 0, 0};
+        for (size_t i = 0; i < total && pos < bytes.size(); i++) {
+            Entry entry;
+            entry.worker = readVarint(bytes, pos);
+            entry.testIndex = readVarint(bytes, pos);
+            entry.sequence = previous.sequence + readVarint(bytes, pos);
+            entry.startNanos = previous.startNanos + unzigzag(readVarint(bytes, pos));
+            entry.endNanos = entry.startNanos + readVarint(bytes, pos);
+            entry.seed = seedFor(entry.testIndex);
+            entries.push_back(entry);
+            previous = entry;
+        }
+    }
+
+    uint64_t getRunSeed() const {
+        return runSeed;
+    }
+
+    uint64_t seedFor(size_t testIndex) const {
+        uint64_t key[2] = {runSeed, testIndex};
+        return hashBytes(string_view((const char*)key, sizeof(key)));
+    }
+
+    //   :   
+    void start() {
+        lock_guard<mutex> guard(lock);
+        entries.clear();
+        origin = chrono::steady_clock::now();
+    }
+
+    int64_t nanosSinceStart(chrono::steady_clock::time_point moment) const {
+        return chrono::duration_cast<chrono::nanoseconds>(moment - origin).count();
+    }
+
+    //         
+    void append(const vector<Entry>& batch) {
+        lock_guard<mutex> guard(lock);
+        entries.insert(entries.end(), batch.begin(), batch.end());
+    }
+
+    //    
+    vector<Entry> getEntries() const {
+        lock_guard<mutex> guard(lock);
+        vector<Entry> sorted = entries;
+        sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+            return a.sequence < b.sequence;
+        });
+        return sorted;
+    }
+
+    void save(const string& path) const {
+        vector<Entry> sorted = getEntries();
+        string bytes;
+        appendVarint(bytes, MAGIC);
+        appendVarint(bytes, runSeed);
+        appendVarint(bytes, sorted.size());
+        Entry previous = {0, 0, 0, 0, 0, 0};
+        for (const Entry& entry : sorted) {
+            appendVarint(bytes, entry.worker);
+            appendVarint(bytes, entry.testIndex);
+            appendVarint(bytes, entry.sequence - previous.sequence);
+            appendVarint(bytes, zigzag(entry.startNanos - previous.startNanos));
+            appendVarint(bytes, max<int64_t>(0, entry.endNanos - entry.startNanos));
+            previous = entry;
+        }
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file || fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size() || fclose(file) != 0) {
+            throw runtime_error("Cannot write execution log: " + path);
+        }
+    }
+};
+
+//    
+struct TestResult {
+    shared_ptr<TestCaseBase> test;
+    bool passed;
+};
+
+//  ,     (  );
+//   ,  
+class FixtureStack {
+private:
+    vector<pair<const FixtureGroup*, unique_ptr<Fixture>>> fixtures;
+
+public:
+    FixtureStack() = default;
+    FixtureStack(const FixtureStack&) = delete;
+    FixtureStack& operator=(const FixtureStack&) = delete;
+
+    //  tearDown   ,   setUp,     
+    ~FixtureStack() {
+        for (auto it = fixtures.rbegin(); it != fixtures.rend(); ++it) {
+            if (!it->second) {
+                continue;
+            }
+            try {
+                it->second->tearDown();
+            } catch (const exception& e) {
+                cerr << "Fixture teardown failed for group " << it->first->getName() << ": " << e.what() << endl;
+            } catch (...) {
+                cerr << "Fixture teardown failed for group " << it->first->getName() << endl;
+            }
+        }
+    }
+
+    bool contains(const FixtureGroup* group) const {
+        return find_if(fixtures.begin(), fixtures.end(), [group](const pair<const FixtureGroup*, unique_ptr<Fixture>>& entry) {
+            return entry.first == group;
+        }) != fixtures.end();
+    }
+
+    // nullptr -      setUp  
+    const Fixture* find(const FixtureGroup* group) const {
+        for (const auto& entry : fixtures) {
+            if (entry.first == group) {
+                return entry.second.get();
+            }
+        }
+        return nullptr;
+    }
+
+    const Fixture* push(const FixtureGroup* group) {
+        fixtures.emplace_back(group, group->setUpFixture());
+        return fixtures.back().second.get();
+    }
+};
+
+//  TestSuite
+class TestSuite {
+public:
+    //         (nullptr   )
+    struct ScheduledTest {
+        shared_ptr<TestCaseBase> test;
+        const FixtureGroup* group;
+    };
+
+private:
+    vector<shared_ptr<TestCaseBase>> tests;
+    vector<shared_ptr<FixtureGroup>> fixtureGroups;
+    static int totalTestSuitesCreated;
+
+    //  :   -   indexedTests. 
+    //        (nullptr)  compact()
+    bool substringIndexEnabled = false;
+    vector<shared_ptr<TestCaseBase>> indexedTests;
+    TrigramIndex inputIndex;
+    TrigramIndex expectedIndex;
+    size_t tombstoneCount = 0;
+    double compactionThreshold = 0.25;  //  ,    
+
+    vector<shared_ptr<TestCaseBase>> findBySubstring(const string& pattern, bool inInput) const {
+        vector<shared_ptr<TestCaseBase>> found;
+        auto contains = [&](const shared_ptr<TestCaseBase>& test) {
+            return (inInput ? test->inputView() : test->expectedView()).find(pattern) != string_view::npos;
+        };
+        if (!substringIndexEnabled || pattern.size() < 3) {
+            copy_if(tests.begin(), tests.end(), back_inserter(found), contains);
+            return found;
+        }
+        for (uint32_t document : (inInput ? inputIndex : expectedIndex).candidates(pattern)) {
+            if (indexedTests[document] && contains(indexedTests[document])) {
+                found.push_back(indexedTests[document]);
+            }
+        }
+        return found;
+    }
+
+    void addToIndex(const shared_ptr<TestCaseBase>& test) {
+        uint32_t document = indexedTests.size();
+        indexedTests.push_back(test);
+        inputIndex.add(document, test->inputView());
+        expectedIndex.add(document, test->expectedView());
+    }
+
+    void compactIfNeeded() {
+        if (tombstoneCount > compactionThreshold * (indexedTests.size() - tombstoneCount)) {
+            compact();
+        }
+    }
+
+    static bool runWithSeed(const ScheduledTest& entry, uint64_t seed, const FixtureStack& processFixtures, FixtureStack& threadFixtures) {
+        TestContext::setSeed(seed);
+        try {
+            return runScheduled(entry, processFixtures, threadFixtures);
+        } catch (const bad_alloc&) {
+            return false;
+        }
+    }
+
+    //  worker( )  threadCount ,  -  
+    template <class Worker>
+    static void runWorkers(unsigned threadCount, Worker worker) {
+        vector<thread> threads;
+        for (unsigned t = 1; t < max(1u, threadCount); t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    static vector<TestResult> collectResults(const vector<ScheduledTest>& schedule, const vector<char>& passed) {
+        vector<TestResult> results;
+        for (size_t i = 0; i < schedule.size(); i++) {
+            results.push_back({schedule[i].test, passed[i] != 0});
+        }
+        return results;
+    }
+
+public:
+    //  PerProcess    (. runScheduled)
+    void setUpProcessFixtures(FixtureStack& processFixtures) const {
+        for (const auto& group : fixtureGroups) {
+            if (group->getScope() == FixtureScope::PerProcess && !group->getTests().empty()) {
+                processFixtures.push(group.get());
+            }
+        }
+    }
+
+    //   ,    
+    bool hasFixtureTests() const {
+        return any_of(fixtureGroups.begin(), fixtureGroups.end(), [](const shared_ptr<FixtureGroup>& group) {
+            return !group->getTests().empty();
+        });
+    }
+
+    //    ;  PerProcess   processFixtures,
+    // PerThread   threadFixtures   
+    static bool runScheduled(const ScheduledTest& entry, const FixtureStack& processFixtures, FixtureStack& threadFixtures) {
+        try {
+            if (!entry.group) {
+                return entry.test->runTest();
+            }
+            const Fixture* fixture = nullptr;
+            if (entry.group->getScope() == FixtureScope::PerProcess) {
+                fixture = processFixtures.find(entry.group);
+            } else if (threadFixtures.contains(entry.group)) {
+                fixture = threadFixtures.find(entry.group);
+            } else {
+                fixture = threadFixtures.push(entry.group);
+            }
+            return fixture && entry.test->runWithFixture(*fixture);
+        } catch (const bad_alloc&) {
+            throw;  //     (. ForkServer)
+        } catch (const exception& e) {
+            cerr << "Test threw an exception: " << e.what() << endl;
+            return false;
+        }
+    }
+
+public:
+    TestSuite() {
+        totalTestSuitesCreated++;
+    }
+
+    void addTest(shared_ptr<TestCaseBase> test) {
+        tests.push_back(test);
+        if (substringIndexEnabled) {
+            addToIndex(test);
+        }
+    }
+
+    //  ,   predicate  true,   
+    // (   ,     ).
+    //      ,     
+    //   ;  ,   
+    //   (. setCompactionThreshold),    compact()
+    size_t removeTests(const function<bool(const TestCaseBase&)>& predicate) {
+        unordered_set<const TestCaseBase*> removed;
+        tests.erase(remove_if(tests.begin(), tests.end(), [&](const shared_ptr<TestCaseBase>& test) {
+            if (!predicate(*test)) {
+                return false;
+            }
+            removed.insert(test.get());
+            return true;
+        }), tests.end());
+        size_t count = removed.size();
+        //      (,  Task), 
+        //      (  )
+        for (auto& group : fixtureGroups) {
+            vector<shared_ptr<TestCaseBase>> kept;
+            for (const auto& test : group->getTests()) {
+                if (!predicate(*test)) {
+                    kept.push_back(test);
+                }
+            }
+            if (kept.size() != group->getTests().size()) {
+                count += group->getTests().size() - kept.size();
+                group = group->withTests(move(kept));
+            }
+        }
+        if (substringIndexEnabled && !removed.empty()) {
+            for (auto& test : indexedTests) {
+                if (test && removed.count(test.get())) {
+                    test = nullptr;
+                    tombstoneCount++;
+                }
+            }
+            compactIfNeeded();
+        }
+        return count;
+    }
+
+    //    (, )
+    size_t removeTests(const vector<shared_ptr<TestCaseBase>>& victims) {
+        unordered_set<const TestCaseBase*> targets;
+        for (const auto& test : victims) {
+            targets.insert(test.get());
+        }
+        return removeTests([&targets](const TestCaseBase& test) {
+            return targets.count(&test) != 0;
+        });
+    }
+
+    //    ,   ;  (, ).
+    //      ,    
+    size_t replaceTests(const vector<pair<shared_ptr<TestCaseBase>, shared_ptr<TestCaseBase>>>& replacements) {
+        unordered_map<const TestCaseBase*, shared_ptr<TestCaseBase>> byOld;
+        for (const auto& replacement : replacements) {
+            byOld[replacement.first.get()] = replacement.second;
+        }
+        size_t count = 0;
+        for (auto& test : tests) {
+            auto found = byOld.find(test.get());
+            if (found != byOld.end()) {
+                test = found->second;
+                count++;
+            }
+        }
+        for (auto& group : fixtureGroups) {
+            vector<shared_ptr<TestCaseBase>> updated = group->getTests();
+            size_t groupCount = 0;
+            for (auto& test : updated) {
+                auto found = byOld.find(test.get());
+                if (found != byOld.end()) {
+                    test = found->second;
+                    groupCount++;
+                }
+            }
+            if (groupCount) {
+                count += groupCount;
+                group = group->withTests(move(updated));  //   ,   removeTests
+            }
+        }
+        if (substringIndexEnabled) {
+            size_t documentCount = indexedTests.size();
+            for (size_t document = 0; document < documentCount; document++) {
+                auto found = indexedTests[document] ? byOld.find(indexedTests[document].get()) : byOld.end();
+                if (found != byOld.end()) {
+                    indexedTests[document] = nullptr;
+                    tombstoneCount++;
+                    addToIndex(found->second);
+                }
+            }
+            compactIfNeeded();
+        }
+        return count;
+    }
+
+    //         
+    void compact(unsigned threadCount = thread::hardware_concurrency()) {
+        tests.shrink_to_fit();
+        if (substringIndexEnabled) {
+            enableSubstringIndex(threadCount);
+        }
+    }
+
+    void setCompactionThreshold(double fraction) {
+        compactionThreshold = fraction;
+    }
+
+    size_t getTombstoneCount() const {
+        return tombstoneCount;
+    }
+
+    //     input  expected;     addTest
+    void enableSubstringIndex(unsigned threadCount = thread::hardware_concurrency()) {
+        indexedTests = tests;
+        tombstoneCount = 0;
+        vector<string_view> inputs, expecteds;
+        for (const auto& test : indexedTests) {
+            inputs.push_back(test->inputView());
+            expecteds.push_back(test->expectedView());
+        }
+        inputIndex = TrigramIndex::build(inputs, threadCount);
+        expectedIndex = TrigramIndex::build(expecteds, threadCount);
+        substringIndexEnabled = true;
+    }
+
+    // ,  input   pattern (  )
+    vector<shared_ptr<TestCaseBase>> findTestsByInputSubstring(const string& pattern) const {
+        return findBySubstring(pattern, true);
+    }
+
+    vector<shared_ptr<TestCaseBase>> findTestsByExpectedSubstring(const string& pattern) const {
+        return findBySubstring(pattern, false);
+    }
+
+    void addFixtureGroup(shared_ptr<FixtureGroup> group) {
+        fixtureGroups.push_back(group);
+    }
+
+    const vector<shared_ptr<TestCaseBase>>& getTests() const {
+        return tests;
+    }
+
+    const vector<shared_ptr<FixtureGroup>>& getFixtureGroups() const {
+        return fixtureGroups;
+    }
+
+    //   ,  :     
+    vector<ScheduledTest> getSchedule() const {
+        vector<ScheduledTest> schedule;
+        for (const auto& test : tests) {
+            schedule.push_back({test, nullptr});
+        }
+        for (const auto& group : fixtureGroups) {
+            for (const auto& test : group->getTests()) {
+                schedule.push_back({test, group.get()});
+            }
+        }
+        return schedule;
+    }
+
+    //    ,  .  PerProcess
+    //           ,
+    //  PerThread -           
+    //   log,     ,   
+    //  (TestContext)   log;     
+    vector<TestResult> runAll(unsigned threadCount = 1, ExecutionLog* log = nullptr) const {
+        vector<ScheduledTest> schedule = getSchedule();
+        vector<char> passed(schedule.size(), 0);
+        FixtureStack processFixtures;
+        setUpProcessFixtures(processFixtures);
+        if (log) {
+            log->start();
+        }
+
+        atomic<size_t> next(0);
+        auto worker = [&](unsigned workerIndex) {
+            FixtureStack threadFixtures;
+            vector<ExecutionLog::Entry> entries;
+            for (size_t i = next++; i < schedule.size(); i = next++) {
+                uint64_t seed = log ? log->seedFor(i) : i;
+                auto started = chrono::steady_clock::now();
+                passed[i] = runWithSeed(schedule[i], seed, processFixtures, threadFixtures);
+                if (log) {
+                    entries.push_back({workerIndex, (uint32_t)i, i, seed, log->nanosSinceStart(started),
+                                       log->nanosSinceStart(chrono::steady_clock::now())});
+                }
+            }
+            if (log) {
+                log->append(entries);
+            }
+        };
+        runWorkers(threadCount, worker);
+        return collectResults(schedule, passed);
+    }
+
+    //    :     
+    //      ;   w  
+    // w % threadCount,         
+    vector<TestResult> replay(const ExecutionLog& log, unsigned threadCount = 1) const {
+        vector<ScheduledTest> schedule = getSchedule();
+        vector<ExecutionLog::Entry> entries = log.getEntries();
+        for (const auto& entry : entries) {
+            if (entry.testIndex >= schedule.size()) {
+                throw runtime_error("Execution log does not match the suite");
+            }
+        }
+        threadCount = max(1u, threadCount);
+        vector<char> passed(schedule.size(), 0);
+        FixtureStack processFixtures;
+        setUpProcessFixtures(processFixtures);
+
+        mutex turnLock;
+        condition_variable turnChanged;
+        size_t turn = 0;
+        auto worker = [&](unsigned workerIndex) {
+            FixtureStack threadFixtures;
+            for (size_t rank = 0; rank < entries.size(); rank++) {
+                const ExecutionLog::Entry& entry = entries[rank];
+                if (entry.worker % threadCount != workerIndex) {
+                    continue;
+                }
+                {
+                    unique_lock<mutex> guard(turnLock);
+                    turnChanged.wait(guard, [&]() { return turn == rank; });
+                    turn++;
+                }
+                turnChanged.notify_all();
+                passed[entry.testIndex] = runWithSeed(schedule[entry.testIndex], entry.seed, processFixtures, threadFixtures);
+            }
+        };
+        runWorkers(threadCount, worker);
+        return collectResults(schedule, passed);
+    }
+
+    int getTestCount() const {
+        return tests.size();
+    }
+
+    static int getTotalTestSuitesCreated() {
+        return totalTestSuitesCreated;
+    }
+
+    void sortTestsByInput() {
+        sort(tests.begin(), tests.end(), [](const shared_ptr<TestCaseBase>& a, const shared_ptr<TestCaseBase>& b) {
+            return a->inputView() < b->inputView();
+        });
+    }
+
+    shared_ptr<TestCaseBase> findTestByExpected(const string& expected) const {
+        auto it = find_if(tests.begin(), tests.end(), [&expected](const shared_ptr<TestCaseBase>& test) {
+            return test->expectedView() == expected;
+        });
+        return (it != tests.end()) ? *it : nullptr;
+    }
+
+    //      (. SuiteImage);    
+    void saveImage(const string& path) const {
+        SuiteImage::write(tests, path);
+    }
+
+    static shared_ptr<const SuiteImage> loadImage(const string& path) {
+        return make_shared<const SuiteImage>(path);
+    }
+};
+
+int TestSuite::totalTestSuitesCreated = 0;
+
+//    :     ,
+//         (O(log n) ),
+//      
+class PersistentTestSuite {
+private:
+    struct Node {
+        shared_ptr<TestCaseBase> test;
+        shared_ptr<const Node> left;
+        shared_ptr<const Node> right;
+        size_t size;
+        uint32_t priority;
+    };
+    using NodePtr = shared_ptr<const Node>;
+
+    NodePtr root;
+
+    explicit PersistentTestSuite(NodePtr rootNode) : root(move(rootNode)) {}
+
+    static size_t sizeOf(const NodePtr& node) {
+        return node ? node->size : 0;
+    }
+
+    static uint32_t randomPriority() {
+        thread_local mt19937 generator(random_device{}());
+        return generator();
+    }
+
+    static NodePtr makeNode(shared_ptr<TestCaseBase> test, NodePtr left, NodePtr right, uint32_t priority) {
+        size_t size = sizeOf(left) + sizeOf(right) + 1;
+        return make_shared<const Node>(Node{move(test), move(left), move(right), size, priority});
+    }
+
+    static NodePtr merge(const NodePtr& a, const NodePtr& b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (a->priority > b->priority) {
+            return makeNode(a->test, a->left, merge(a->right, b), a->priority);
+        }
+        return makeNode(b->test, merge(a, b->left), b->right, b->priority);
+    }
+
+    //  count    left,   right
+    static void split(const NodePtr& node, size_t count, NodePtr& left, NodePtr& right) {
+        if (!node) {
+            left = right = nullptr;
+            return;
+        }
+        if (sizeOf(node->left) < count) {
+            NodePtr rest;
+            split(node->right, count - sizeOf(node->left) - 1, rest, right);
+            left = makeNode(node->test, node->left, rest, node->priority);
+        } else {
+            NodePtr rest;
+            split(node->left, count, left, rest);
+            right = makeNode(node->test, rest, node->right, node->priority);
+        }
+    }
+
+public:
+    PersistentTestSuite() = default;
+
+    static PersistentTestSuite fromTestSuite(const TestSuite& suite) {
+        PersistentTestSuite result;
+        for (const auto& test : suite.getTests()) {
+            result = result.addTest(test);
+        }
+        return result;
+    }
+
+    PersistentTestSuite addTest(shared_ptr<TestCaseBase> test) const {
+        return PersistentTestSuite(merge(root, makeNode(move(test), nullptr, nullptr, randomPriority())));
+    }
+
+    // position <= getTestCount(),  out_of_range
+    PersistentTestSuite insertTest(size_t position, shared_ptr<TestCaseBase> test) const {
+        if (position > sizeOf(root)) {
+            throw out_of_range("PersistentTestSuite: insert position out of range");
+        }
+        NodePtr left, right;
+        split(root, position, left, right);
+        return PersistentTestSuite(merge(merge(left, makeNode(move(test), nullptr, nullptr, randomPriority())), right));
+    }
+
+    PersistentTestSuite removeTest(size_t position) const {
+        if (position >= sizeOf(root)) {
+            throw out_of_range("PersistentTestSuite: remove position out of range");
+        }
+        NodePtr left, middle, right;
+        split(root, position, left, right);
+        split(right, 1, middle, right);
+        return PersistentTestSuite(merge(left, right));
+    }
+
+    //     from   to;   getTestCount()
+    PersistentTestSuite moveTest(size_t from, size_t to) const {
+        if (from >= sizeOf(root) || to >= sizeOf(root)) {
+            throw out_of_range("PersistentTestSuite: move position out of range");
+        }
+        shared_ptr<TestCaseBase> test = getTest(from);
+        return removeTest(from).insertTest(to, test);
+    }
+
+    PersistentTestSuite sortedByInput() const {
+        vector<shared_ptr<TestCaseBase>> tests;
+        forEach([&tests](const shared_ptr<TestCaseBase>& test) {
+            tests.push_back(test);
+        });
+        stable_sort(tests.begin(), tests.end(), [](const shared_ptr<TestCaseBase>& a, const shared_ptr<TestCaseBase>& b) {
+            return a->inputView() < b->inputView();
+        });
+        PersistentTestSuite result;
+        for (const auto& test : tests) {
+            result = result.addTest(test);
+        }
+        return result;
+    }
+
+    shared_ptr<TestCaseBase> getTest(size_t position) const {
+        const Node* node = root.get();
+        while (node) {
+            size_t leftSize = sizeOf(node->left);
+            if (position < leftSize) {
+                node = node->left.get();
+            } else if (position == leftSize) {
+                return node->test;
+            } else {
+                position -= leftSize + 1;
+                node = node->right.get();
+            }
+        }
+        return nullptr;
+    }
+
+    int getTestCount() const {
+        return sizeOf(root);
+    }
+
+    //   ;  ,    
+    template <class Visitor>
+    void forEach(Visitor visit) const {
+        vector<const Node*> stack;
+        const Node* node = root.get();
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left.get();
+            }
+            node = stack.back();
+            stack.pop_back();
+            visit(node->test);
+            node = node->right.get();
+        }
+    }
+
+    shared_ptr<TestCaseBase> findTestByExpected(const string& expected) const {
+        shared_ptr<TestCaseBase> found;
+        forEach([&](const shared_ptr<TestCaseBase>& test) {
+            if (!found && test->expectedView() == expected) {
+                found = test;
+            }
+        });
+        return found;
+    }
+
+    TestSuite toTestSuite() const {
+        TestSuite suite;
+        forEach([&suite](const shared_ptr<TestCaseBase>& test) {
+            suite.addTest(test);
+        });
+        return suite;
+    }
+};
+
+// ,     :   
+// ,     O(1)     
+class VersionedTestSuite {
+private:
+    mutable mutex lock;
+    PersistentTestSuite current;
+
+public:
+    PersistentTestSuite snapshot() const {
+        lock_guard<mutex> guard(lock);
+        return current;
+    }
+
+    void addTest(shared_ptr<TestCaseBase> test) {
+        lock_guard<mutex> guard(lock);
+        current = current.addTest(move(test));
+    }
+
+    void removeTest(size_t position) {
+        lock_guard<mutex> guard(lock);
+        current = current.removeTest(position);
+    }
+
+    void moveTest(size_t from, size_t to) {
+        lock_guard<mutex> guard(lock);
+        current = current.moveTest(from, to);
+    }
+
+    //      
+    void update(const function<PersistentTestSuite(const PersistentTestSuite&)>& change) {
+        lock_guard<mutex> guard(lock);
+        current = change(current);
+    }
+};
+
+// ,  input/expected   
+class CompressedTestCase {
+private:
+    CompressedString input;
+    CompressedString expected;
+    unique_ptr<ITestRunner> testRunner;
+
+public:
+    CompressedTestCase(const CompressedString& input_str, const CompressedString& expected_str, unique_ptr<ITestRunner> runner)
+        : input(input_str), expected(expected_str), testRunner(move(runner)) {}
+
+    //          
+    bool runTest() const {
+        if (testRunner->isPureEquality()) {
+            return input == expected;
+        }
+        return testRunner->executeView(input.str(), expected.str());
+    }
+
+    const CompressedString& getCompressedInput() const {
+        return input;
+    }
+
+    const CompressedString& getCompressedExpected() const {
+        return expected;
+    }
+
+    string getInput() const {
+        return input.str();
+    }
+
+    string getExpected() const {
+        return expected.str();
+    }
+};
+
+//   TestSuite:       
+class CompressedTestSuite {
+private:
+    static constexpr size_t MAX_SAMPLE_BYTES = 1 << 16;
+
+    shared_ptr<const SymbolTable> table;
+    vector<CompressedTestCase> tests;
+
+    static vector<string> collectSample(const TestSuite& suite) {
+        const auto& source = suite.getTests();
+        size_t totalBytes = 0;
+        for (const auto& test : source) {
+            totalBytes += test->inputView().size() + test->expectedView().size();
+        }
+        //      ,    MAX_SAMPLE_BYTES
+        size_t step = max<size_t>(1, totalBytes / MAX_SAMPLE_BYTES);
+        vector<string> sample;
+        for (size_t i = 0; i < source.size(); i += step) {
+            sample.emplace_back(source[i]->inputView());
+            sample.emplace_back(source[i]->expectedView());
+        }
+        return sample;
+    }
+
+public:
+    explicit CompressedTestSuite(const TestSuite& suite)
+        : table(SymbolTable::train(collectSample(suite))) {
+        tests.reserve(suite.getTests().size());
+        for (const auto& test : suite.getTests()) {
+            tests.emplace_back(compress(string(test->inputView())), compress(string(test->expectedView())),
+                unique_ptr<ITestRunner>(test->getRunner().clone()));
+        }
+    }
+
+    CompressedString compress(const string& text) const {
+        return CompressedString(table, text);
+    }
+
+    const vector<CompressedTestCase>& getTests() const {
+        return tests;
+    }
+
+    int getTestCount() const {
+        return tests.size();
+    }
+
+    //          
+    const CompressedTestCase* findTestByExpected(const string& expected) const {
+        CompressedString needle = compress(expected);
+        auto it = find_if(tests.begin(), tests.end(), [&needle](const CompressedTestCase& test) {
+            return test.getCompressedExpected() == needle;
+        });
+        return (it != tests.end()) ? &*it : nullptr;
+    }
+
+    size_t getCompressedSize() const {
+        size_t total = 0;
+        for (const auto& test : tests) {
+            total += test.getCompressedInput().compressedSize() + test.getCompressedExpected().compressedSize();
+        }
+        return total;
+    }
+};
+
+//    :       ,
+// input  expected         
+// ,       (prefetch).
+//      executeView, 
+//  runTest (,  AdvancedTestCase)  ,
+//         
+class ExecutionPlan {
+private:
+    static constexpr size_t PREFETCH_DISTANCE = 8;
+
+    struct PlannedTest {
+        const ITestRunner* runner;
+        size_t offset;  // input,    expected
+        uint32_t inputLength;
+        uint32_t expectedLength;
+        uint32_t originalIndex;
+    };
+
+    vector<shared_ptr<TestCaseBase>> owners;  //   
+    vector<PlannedTest> planned;
+    string arena;
+
+public:
+    //      32-:     
+    explicit ExecutionPlan(const vector<shared_ptr<TestCaseBase>>& tests) : owners(tests) {
+        if (tests.size() > UINT32_MAX) {
+            throw runtime_error("ExecutionPlan: suite is too large");
+        }
+        //     :     
+        map<type_index, uint32_t> runnerTypes;
+        vector<pair<pair<uint32_t, size_t>, uint32_t>> keys;
+        size_t totalBytes = 0;
+        for (size_t i = 0; i < tests.size(); i++) {
+            auto type = runnerTypes.emplace(type_index(typeid(tests[i]->getRunner())), runnerTypes.size()).first;
+            if (tests[i]->inputView().size() > UINT32_MAX || tests[i]->expectedView().size() > UINT32_MAX) {
+                throw runtime_error("ExecutionPlan: test data is too large");
+            }
+            size_t size = tests[i]->inputView().size() + tests[i]->expectedView().size();
+            keys.push_back({{type->second, size}, (uint32_t)i});
+            totalBytes += size;
+        }
+        sort(keys.begin(), keys.end());
+
+        arena.reserve(totalBytes);
+        planned.reserve(tests.size());
+        for (const auto& key : keys) {
+            uint32_t index = key.second;
+            const TestCaseBase& test = *tests[index];
+            planned.push_back({&test.getRunner(), arena.size(), (uint32_t)test.inputView().size(),
+                               (uint32_t)test.expectedView().size(), index});
+            arena.append(test.inputView());
+            arena.append(test.expectedView());
+        }
+    }
+
+    //    ,       
+    explicit ExecutionPlan(const TestSuite& suite) : ExecutionPlan(checkedTests(suite)) {}
+
+    static const vector<shared_ptr<TestCaseBase>>& checkedTests(const TestSuite& suite) {
+        if (suite.hasFixtureTests()) {
+            throw runtime_error("ExecutionPlan: fixture groups are not supported, use TestSuite::runAll");
+        }
+        return suite.getTests();
+    }
+
+    size_t getTestCount() const {
+        return planned.size();
+    }
+
+    //        
+    size_t getOriginalIndex(size_t position) const {
+        return planned[position].originalIndex;
+    }
+
+    //    [begin, end); passed   
+    void runRange(size_t begin, size_t end, vector<char>& passed) const {
+        for (size_t i = begin; i < end; i++) {
+            if (i + PREFETCH_DISTANCE < end) {
+                const PlannedTest& ahead = planned[i + PREFETCH_DISTANCE];
+                __builtin_prefetch(arena.data() + ahead.offset);
+                __builtin_prefetch(arena.data() + ahead.offset + ahead.inputLength);
+                __builtin_prefetch(ahead.runner);
+            }
+            const PlannedTest& test = planned[i];
+            const char* data = arena.data() + test.offset;
+            try {
+                passed[i] = test.runner->executeView(string_view(data, test.inputLength),
+                                                     string_view(data + test.inputLength, test.expectedLength));
+            } catch (const exception&) {
+                passed[i] = 0;
+            }
+        }
+    }
+
+    //     
+    vector<TestResult> run() const {
+        vector<char> passed(planned.size(), 0);
+        runRange(0, planned.size(), passed);
+        vector<TestResult> results(planned.size());
+        for (size_t i = 0; i < planned.size(); i++) {
+            results[planned[i].originalIndex] = {owners[planned[i].originalIndex], passed[i] != 0};
+        }
+        return results;
+    }
+};
+
+// NUMA-:  ->  CPU      ( sysfs)
+class NumaTopology {
+private:
+    vector<vector<int>> nodeCpus;
+    vector<vector<int>> distances;
+
+    //  cpulist: "0-3,8-11"
+    static vector<int> parseCpuList(const string& text) {
+        vector<int> cpus;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find(',', pos);
+            string range = text.substr(pos, end == string::npos ? string::npos : end - pos);
+            size_t dash = range.find('-');
+            if (!range.empty() && isdigit((unsigned char)range[0])) {
+                int first = stoi(range);
+                int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (end == string::npos) {
+                break;
+            }
+            pos = end + 1;
+        }
+        return cpus;
+    }
+
+    static string readFile(const string& path) {
+        string text;
+        FILE* file = fopen(path.c_str(), "r");
+        if (file) {
+            char buffer[4096];
+            size_t count;
+            while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                text.append(buffer, count);
+            }
+            fclose(file);
+        }
+        return text;
+    }
+
+public:
+    explicit NumaTopology(const vector<vector<int>>& cpusByNode, const vector<vector<int>>& nodeDistances = {})
+        : nodeCpus(cpusByNode), distances(nodeDistances) {
+        if (distances.size() != nodeCpus.size()) {
+            distances.assign(nodeCpus.size(), vector<int>(nodeCpus.size(), 20));
+            for (size_t i = 0; i < nodeCpus.size(); i++) {
+                distances[i][i] = 10;
+            }
+        }
+    }
+
+    //  sysfs (    NUMA) -     CPU
+    static NumaTopology detect() {
+        vector<vector<int>> cpus;
+        vector<vector<int>> distances;
+        for (int node = 0;; node++) {
+            string base = "/sys/devices/system/node/node" + to_string(node);
+            if (access(base.c_str(), F_OK) != 0) {
+                break;
+            }
+            cpus.push_back(parseCpuList(readFile(base + "/cpulist")));
+            vector<int> row;
+            string distanceText = readFile(base + "/distance");
+            for (size_t pos = 0; pos < distanceText.size();) {
+                char* end = nullptr;
+                long value = strtol(distanceText.c_str() + pos, &end, 10);
+                if (end == distanceText.c_str() + pos) {
+                    break;
+                }
+                row.push_back(value);
+                pos = end - distanceText.c_str();
+            }
+            distances.push_back(row);
+        }
+        //   CPU ( )     
+        vector<vector<int>> usedCpus;
+        vector<size_t> used;
+        for (size_t node = 0; node < cpus.size(); node++) {
+            if (!cpus[node].empty()) {
+                usedCpus.push_back(cpus[node]);
+                used.push_back(node);
+            }
+        }
+        if (usedCpus.empty()) {
+            vector<int> all;
+            for (unsigned cpu = 0; cpu < max(1u, thread::hardware_concurrency()); cpu++) {
+                all.push_back(cpu);
+            }
+            return NumaTopology({all});
+        }
+        vector<vector<int>> usedDistances;
+        for (size_t a : used) {
+            vector<int> row;
+            for (size_t b : used) {
+                row.push_back(a < distances.size() && b < distances[a].size() ? distances[a][b] : (a == b ? 10 : 20));
+            }
+            usedDistances.push_back(row);
+        }
+        return NumaTopology(usedCpus, usedDistances);
+    }
+
+    size_t getNodeCount() const {
+        return nodeCpus.size();
+    }
+
+    const vector<int>& getCpus(size_t node) const {
+        return nodeCpus[node];
+    }
+
+    //      
+    vector<size_t> nodesByDistance(size_t node) const {
+        vector<size_t> order;
+        for (size_t other = 0; other < nodeCpus.size(); other++) {
+            if (other != node) {
+                order.push_back(other);
+            }
+        }
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return distances[node][a] < distances[node][b];
+        });
+        return order;
+    }
+
+    //     CPU ; false,   
+    bool bindCurrentThread(size_t node) const {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : nodeCpus[node]) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+};
+
+// NUMA-:      ,   
+// (ExecutionPlan)  ,    ,   
+//     (first-touch).     
+//       ,  -    .
+//   ExecutionPlan,     :   
+class NumaExecutor {
+private:
+    static constexpr size_t CHUNK_SIZE = 64;
+
+    struct NodePart {
+        size_t firstTest;  //      
+        unique_ptr<ExecutionPlan> plan;
+        vector<char> passed;
+        atomic<size_t> cursor{0};
+    };
+
+    NumaTopology topology;
+    unsigned workersPerNode;
+
+    //    ; false,   
+    static bool claimChunk(NodePart& part, size_t& begin, size_t& end) {
+        begin = part.cursor.fetch_add(CHUNK_SIZE);
+        if (begin >= part.plan->getTestCount()) {
+            return false;
+        }
+        end = min(part.plan->getTestCount(), begin + CHUNK_SIZE);
+        return true;
+    }
+
+public:
+    // workers = 0 -   CPU 
+    explicit NumaExecutor(NumaTopology numaTopology = NumaTopology::detect(), unsigned workers = 0)
+        : topology(move(numaTopology)), workersPerNode(workers) {}
+
+    vector<TestResult> run(const TestSuite& suite) const {
+        const auto& tests = ExecutionPlan::checkedTests(suite);
+        size_t nodeCount = topology.getNodeCount();
+        vector<unique_ptr<NodePart>> parts;
+        size_t step = (tests.size() + nodeCount - 1) / nodeCount;
+        for (size_t node = 0; node < nodeCount; node++) {
+            parts.push_back(make_unique<NodePart>());
+            parts.back()->firstTest = min(tests.size(), node * step);
+        }
+
+        //     
+        vector<thread> builders;
+        for (size_t node = 0; node < nodeCount; node++) {
+            builders.emplace_back([&, node]() {
+                topology.bindCurrentThread(node);
+                size_t begin = parts[node]->firstTest;
+                size_t end = min(tests.size(), begin + step);
+                parts[node]->plan = make_unique<ExecutionPlan>(vector<shared_ptr<TestCaseBase>>(tests.begin() + begin, tests.begin() + end));
+                parts[node]->passed.assign(parts[node]->plan->getTestCount(), 0);
+            });
+        }
+        for (auto& t : builders) {
+            t.join();
+        }
+
+        vector<thread> workers;
+        for (size_t node = 0; node < nodeCount; node++) {
+            unsigned count = workersPerNode ? workersPerNode : max<unsigned>(1, topology.getCpus(node).size());
+            for (unsigned w = 0; w < count; w++) {
+                workers.emplace_back([&, node]() {
+                    topology.bindCurrentThread(node);
+                    vector<size_t> order = {node};
+                    for (size_t other : topology.nodesByDistance(node)) {
+                        order.push_back(other);
+                    }
+                    for (size_t victim : order) {
+                        NodePart& part = *parts[victim];
+                        size_t begin, end;
+                        while (claimChunk(part, begin, end)) {
+                            part.plan->runRange(begin, end, part.passed);
+                        }
+                    }
+                });
+            }
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+
+        vector<TestResult> results(tests.size());
+        for (const auto& part : parts) {
+            for (size_t position = 0; position < part->plan->getTestCount(); position++) {
+                size_t index = part->firstTest + part->plan->getOriginalIndex(position);
+                results[index] = {tests[index], part->passed[position] != 0};
+            }
+        }
+        return results;
+    }
+};
+
+//    AdaptiveExecutor
+struct ScalingSample {
+    unsigned workers;
+    double testsPerSecond;
+    double cpuUtilization;  //   / ( * ); < 1 -  
+};
+
+//  AdaptiveExecutor    
+struct WorkerScalingDecision {
+    string runnerType;
+    unsigned workers;  //   
+    double testsPerSecond;
+    vector<ScalingSample> trajectory;
+};
+
+//     .     ;
+//          
+//     :     
+// (  ,      ), 
+// ,    . ,   ,
+//    ,     .
+//         .
+//    ,    
+class AdaptiveExecutor {
+private:
+    static constexpr size_t CHUNK_SIZE = 16;
+    static constexpr size_t MIN_EPOCH_TESTS = 256;  //  -   
+    static constexpr double TOLERANCE = 0.03;
+    static constexpr double MIN_UTILIZATION = 0.8;
+
+    unsigned maxWorkers;
+    chrono::microseconds epoch;
+    mutable mutex lock;
+    mutable map<type_index, unsigned> learnedWorkers;
+    mutable vector<WorkerScalingDecision> decisions;
+
+    static double processCpuSeconds() {
+        timespec time;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+        return time.tv_sec + time.tv_nsec * 1e-9;
+    }
+
+    WorkerScalingDecision runGroup(const vector<TestSuite::ScheduledTest>& schedule, const vector<size_t>& group,
+                                   const FixtureStack& processFixtures, unsigned initialWorkers, vector<char>& passed) const {
+        atomic<size_t> cursor(0);
+        atomic<size_t> completed(0);
+        atomic<unsigned> active(initialWorkers);
+        bool finished = false;
+        mutex stateLock;
+        condition_variable stateChanged;
+
+        auto worker = [&](unsigned workerIndex) {
+            FixtureStack threadFixtures;
+            while (true) {
+                if (workerIndex >= active) {
+                    unique_lock<mutex> guard(stateLock);
+                    stateChanged.wait(guard, [&]() { return workerIndex < active || finished; });
+                    if (finished) {
+                        return;
+                    }
+                    continue;
+                }
+                size_t begin = cursor.fetch_add(CHUNK_SIZE);
+                if (begin >= group.size()) {
+                    return;
+                }
+                size_t end = min(group.size(), begin + CHUNK_SIZE);
+                for (size_t i = begin; i < end; i++) {
+                    try {
+                        passed[group[i]] = TestSuite::runScheduled(schedule[group[i]], processFixtures, threadFixtures);
+                    } catch (const exception&) {
+                        passed[group[i]] = 0;  //   ExecutionPlan::runRange:  -  
+                    }
+                }
+                if (completed.fetch_add(end - begin) + (end - begin) == group.size()) {
+                    lock_guard<mutex> guard(stateLock);
+                    finished = true;
+                    stateChanged.notify_all();
+                }
+            }
+        };
+        vector<thread> threads;
+        for (unsigned w = 0; w < maxWorkers; w++) {
+            threads.emplace_back(worker, w);
+        }
+
+        WorkerScalingDecision decision = {typeid(schedule[group[0]].test->getRunner()).name(), initialWorkers, 0, {}};
+        auto groupStart = chrono::steady_clock::now();
+        unsigned current = initialWorkers;
+        unsigned step = max(1u, maxWorkers / 4);
+        int direction = current < maxWorkers ? 1 : -1;
+        double previous = 0;
+        auto epochStart = chrono::steady_clock::now();
+        double epochCpuStart = processCpuSeconds();
+        size_t epochCompleted = 0;
+        unique_lock<mutex> guard(stateLock);
+        while (!finished) {
+            stateChanged.wait_for(guard, epoch);
+            size_t done = completed;
+            if (finished || done - epochCompleted < MIN_EPOCH_TESTS) {
+                continue;
+            }
+            auto now = chrono::steady_clock::now();
+            double cpuNow = processCpuSeconds();
+            double seconds = chrono::duration<double>(now - epochStart).count();
+            double throughput = (done - epochCompleted) / seconds;
+            double utilization = (cpuNow - epochCpuStart) / (seconds * current);
+            decision.trajectory.push_back({current, throughput, utilization});
+            bool worse = throughput < previous * (1 - TOLERANCE);
+            bool contended = direction > 0 && throughput < previous * (1 + TOLERANCE) && utilization < MIN_UTILIZATION;
+            if (previous > 0 && (worse || contended)) {
+                direction = -direction;
+                step = max(1u, step / 2);
+            }
+            previous = throughput;
+            int next = (int)current + direction * (int)step;
+            if (next < 1 || next > (int)maxWorkers) {
+                direction = -direction;
+                next = max(1, min((int)maxWorkers, next));
+            }
+            current = next;
+            active = current;
+            stateChanged.notify_all();
+            epochStart = now;
+            epochCpuStart = cpuNow;
+            epochCompleted = done;
+        }
+        guard.unlock();
+        for (auto& t : threads) {
+            t.join();
+        }
+        if (decision.trajectory.empty()) {
+            //     :    
+            decision.testsPerSecond = group.size() / chrono::duration<double>(chrono::steady_clock::now() - groupStart).count();
+            return decision;
+        }
+        //    ;  -   
+        //      (  - )
+        map<unsigned, pair<size_t, double>> visits;
+        for (size_t i = decision.trajectory.size() / 2; i < decision.trajectory.size(); i++) {
+            visits[decision.trajectory[i].workers].first++;
+            visits[decision.trajectory[i].workers].second += decision.trajectory[i].testsPerSecond;
+        }
+        size_t bestCount = 0;
+        for (const auto& visit : visits) {
+            if (visit.second.first > bestCount) {
+                bestCount = visit.second.first;
+                decision.workers = visit.first;
+                decision.testsPerSecond = visit.second.second / visit.second.first;
+            }
+        }
+        return decision;
+    }
+
+public:
+    // maxWorkers = 0 -    
+    explicit AdaptiveExecutor(unsigned workers = 0, chrono::microseconds epochLength = chrono::milliseconds(10))
+        : maxWorkers(workers ? workers : max(1u, thread::hardware_concurrency())), epoch(epochLength) {}
+
+    vector<TestResult> run(const TestSuite& suite) const {
+        vector<TestSuite::ScheduledTest> schedule = suite.getSchedule();
+        map<type_index, vector<size_t>> groups;
+        for (size_t i = 0; i < schedule.size(); i++) {
+            groups[type_index(typeid(schedule[i].test->getRunner()))].push_back(i);
+        }
+        FixtureStack processFixtures;
+        suite.setUpProcessFixtures(processFixtures);
+
+        vector<char> passed(schedule.size(), 0);
+        vector<WorkerScalingDecision> runDecisions;
+        for (const auto& group : groups) {
+            unsigned initial;
+            {
+                lock_guard<mutex> guard(lock);
+                auto learned = learnedWorkers.find(group.first);
+                initial = learned != learnedWorkers.end() ? learned->second : max(1u, maxWorkers / 2);
+            }
+            WorkerScalingDecision decision = runGroup(schedule, group.second, processFixtures, initial, passed);
+            {
+                lock_guard<mutex> guard(lock);
+                learnedWorkers[group.first] = decision.workers;
+            }
+            runDecisions.push_back(move(decision));
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            decisions = move(runDecisions);
+        }
+
+        vector<TestResult> results;
+        for (size_t i = 0; i < schedule.size(); i++) {
+            results.push_back({schedule[i].test, passed[i] != 0});
+        }
+        return results;
+    }
+
+    //   
+    vector<WorkerScalingDecision> getDecisions() const {
+        lock_guard<mutex> guard(lock);
+        return decisions;
+    }
+};
+
+//       
+enum class TestOutcome {
+    Passed,
+    Failed,
+    Crashed,
+    LimitExceeded
+};
+
+//     
+enum class ResourceKind {
+    None,
+    Memory,
+    CpuTime,
+    OpenFiles
+};
+
+// ,   
+struct ResourceUsage {
+    size_t peakMemoryBytes = 0;
+    double cpuSeconds = 0;
+    size_t openFiles = 0;
+};
+
+struct IsolatedTestResult {
+    shared_ptr<TestCaseBase> test;
+    TestOutcome outcome;
+    int signal;  // ,   ( Crashed  LimitExceeded)
+    ResourceKind exceededLimit;
+    ResourceUsage usage;
+};
+
+// Fork-:        
+//  ""   copy-on-write ,   
+//   .   (segfault, abort) 
+// ,    ,       .
+//     (  )  
+//  ,     rlimit
+class ForkServer {
+private:
+    //     
+    struct CaseReport {
+        uint8_t outcome;
+        uint8_t exceededLimit;
+        uint64_t peakMemoryBytes;
+        double cpuSeconds;
+        uint64_t openFiles;
+    };
+
+    struct Child {
+        pid_t pid;
+        int fd;
+        size_t begin;
+        size_t end;
+        size_t reported;
+        string partial;
+    };
+
+    vector<TestSuite::ScheduledTest> schedule;
+    size_t batchSize;
+    unsigned maxChildren;
+    FixtureStack processFixtures;
+    FixtureStack workerFixtures;
+
+    ResourceLimits limitsFor(size_t index) const {
+        const ResourceLimits& own = schedule[index].test->getResourceLimits();
+        if (own.isSet() || !schedule[index].group) {
+            return own;
+        }
+        return schedule[index].group->getResourceLimits();
+    }
+
+    //     .   fcntl,
+    //   /proc/self/fd:      opendir  
+    static vector<int> listOpenFiles() {
+        rlimit nofile;
+        getrlimit(RLIMIT_NOFILE, &nofile);
+        int bound = (int)min<rlim_t>(nofile.rlim_cur, 65536);
+        vector<int> fds;
+        for (int fd = 0; fd < bound; fd++) {
+            if (fcntl(fd, F_GETFD) != -1) {
+                fds.push_back(fd);
+            }
+        }
+        return fds;
+    }
+
+    static size_t currentAddressSpace() {
+        size_t pages = 0;
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (statm) {
+            if (fscanf(statm, "%zu", &pages) != 1) {
+                pages = 0;
+            }
+            fclose(statm);
+        }
+        return pages * sysconf(_SC_PAGESIZE);
+    }
+
+    static double cpuSecondsOf(const rusage& usage) {
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    //       :
+    //           
+    static void applyLimits(const ResourceLimits& limits, size_t baselineFiles, int highestFile) {
+        if (limits.memoryBytes) {
+            rlimit memory = {currentAddressSpace() + limits.memoryBytes, currentAddressSpace() + limits.memoryBytes};
+            setrlimit(RLIMIT_AS, &memory);
+        }
+        if (limits.cpuSeconds > 0) {
+            rlim_t seconds = (rlim_t)ceil(limits.cpuSeconds);
+            rlimit cpu = {seconds, seconds + 1};
+            setrlimit(RLIMIT_CPU, &cpu);
+        }
+        if (limits.openFiles) {
+            rlim_t files = max<rlim_t>(highestFile + 1, baselineFiles + limits.openFiles);
+            rlimit nofile = {files, files};
+            setrlimit(RLIMIT_NOFILE, &nofile);
+        }
+    }
+
+    //   :   CaseReport  
+    [[noreturn]] void runChild(int fd, size_t begin, size_t end) {
+        vector<int> inherited = listOpenFiles();
+        ResourceLimits limits = limitsFor(begin);
+        if (end - begin == 1 && limits.isSet()) {
+            applyLimits(limits, inherited.size(), inherited.empty() ? 0 : inherited.back());
+        }
+        for (size_t i = begin; i < end; i++) {
+            rusage before, after;
+            getrusage(RUSAGE_SELF, &before);
+            CaseReport report = {};
+            try {
+                report.outcome = (uint8_t)(TestSuite::runScheduled(schedule[i], processFixtures, workerFixtures)
+                    ? TestOutcome::Passed : TestOutcome::Failed);
+            } catch (const bad_alloc&) {
+                report.outcome = (uint8_t)(limits.memoryBytes ? TestOutcome::LimitExceeded : TestOutcome::Crashed);
+                report.exceededLimit = (uint8_t)(limits.memoryBytes ? ResourceKind::Memory : ResourceKind::None);
+            }
+            getrusage(RUSAGE_SELF, &after);
+            report.cpuSeconds = cpuSecondsOf(after) - cpuSecondsOf(before);
+            report.peakMemoryBytes = (uint64_t)after.ru_maxrss * 1024;
+            size_t openNow = listOpenFiles().size();
+            report.openFiles = openNow > inherited.size() ? openNow - inherited.size() : 0;
+            if (limits.openFiles && report.openFiles >= limits.openFiles && report.outcome != (uint8_t)TestOutcome::Passed) {
+                report.outcome = (uint8_t)TestOutcome::LimitExceeded;
+                report.exceededLimit = (uint8_t)ResourceKind::OpenFiles;
+            }
+            if (write(fd, &report, sizeof(report)) != (ssize_t)sizeof(report)) {
+                break;
+            }
+        }
+        cout.flush();
+        cerr.flush();
+        _exit(0);
+    }
+
+    Child spawn(size_t begin, size_t end) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw runtime_error("ForkServer: pipe failed");
+        }
+        cout.flush();
+        cerr.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw runtime_error("ForkServer: fork failed");
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            runChild(fds[1], begin, end);
+        }
+        close(fds[1]);
+        return {pid, fds[0], begin, end, 0, string()};
+    }
+
+    //    batchSize;    -  
+    deque<pair<size_t, size_t>> splitIntoBatches(size_t begin, size_t end) const {
+        deque<pair<size_t, size_t>> batches;
+        size_t start = begin;
+        for (size_t i = begin; i < end; i++) {
+            if (limitsFor(i).isSet()) {
+                if (start < i) {
+                    batches.emplace_back(start, i);
+                }
+                batches.emplace_back(i, i + 1);
+                start = i + 1;
+            } else if (i + 1 - start == batchSize) {
+                batches.emplace_back(start, i + 1);
+                start = i + 1;
+            }
+        }
+        if (start < end) {
+            batches.emplace_back(start, end);
+        }
+        return batches;
+    }
+
+    //  ,     crashed:       
+    void reportTermination(IsolatedTestResult& result, const ResourceLimits& limits, int status, const rusage& usage) const {
+        result.outcome = TestOutcome::Crashed;
+        result.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+        result.usage.cpuSeconds = cpuSecondsOf(usage);
+        result.usage.peakMemoryBytes = (size_t)usage.ru_maxrss * 1024;
+        bool killedForCpu = result.signal == SIGXCPU || (result.signal == SIGKILL && result.usage.cpuSeconds >= limits.cpuSeconds);
+        if (limits.cpuSeconds > 0 && killedForCpu) {
+            result.outcome = TestOutcome::LimitExceeded;
+            result.exceededLimit = ResourceKind::CpuTime;
+        }
+    }
+
+public:
+    //     ,   fork,
+    //     
+    ForkServer(const TestSuite& suite, size_t testsPerChild = 64, unsigned parallelChildren = 1)
+        : schedule(suite.getSchedule()), batchSize(max<size_t>(1, testsPerChild)),
+          maxChildren(max(1u, parallelChildren)) {
+        for (const auto& group : suite.getFixtureGroups()) {
+            if (group->getTests().empty()) {
+                continue;
+            }
+            if (group->getScope() == FixtureScope::PerProcess) {
+                processFixtures.push(group.get());
+            } else {
+                workerFixtures.push(group.get());
+            }
+        }
+    }
+
+    vector<IsolatedTestResult> run() {
+        vector<IsolatedTestResult> results;
+        for (const auto& entry : schedule) {
+            results.push_back({entry.test, TestOutcome::Failed, 0, ResourceKind::None, ResourceUsage()});
+        }
+        deque<pair<size_t, size_t>> pending = splitIntoBatches(0, schedule.size());
+
+        vector<Child> running;
+        while (!pending.empty() || !running.empty()) {
+            while (running.size() < maxChildren && !pending.empty()) {
+                running.push_back(spawn(pending.front().first, pending.front().second));
+                pending.pop_front();
+            }
+            vector<pollfd> fds;
+            for (const auto& child : running) {
+                fds.push_back({child.fd, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                continue;
+            }
+            for (size_t c = running.size(); c-- > 0;) {
+                if (!fds[c].revents) {
+                    continue;
+                }
+                Child& child = running[c];
+                char buffer[sizeof(CaseReport) * 32];
+                ssize_t count = read(child.fd, buffer, sizeof(buffer));
+                if (count > 0) {
+                    child.partial.append(buffer, count);
+                    size_t offset = 0;
+                    for (; offset + sizeof(CaseReport) <= child.partial.size(); offset += sizeof(CaseReport)) {
+                        CaseReport report;
+                        memcpy(&report, child.partial.data() + offset, sizeof(report));
+                        IsolatedTestResult& result = results[child.begin + child.reported++];
+                        result.outcome = (TestOutcome)report.outcome;
+                        result.exceededLimit = (ResourceKind)report.exceededLimit;
+                        result.usage = {(size_t)report.peakMemoryBytes, report.cpuSeconds, (size_t)report.openFiles};
+                    }
+                    child.partial.erase(0, offset);
+                    continue;
+                }
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                //   :     ,    
+                close(child.fd);
+                int status = 0;
+                rusage usage = {};
+                wait4(child.pid, &status, 0, &usage);
+                size_t crashed = child.begin + child.reported;
+                if (crashed < child.end) {
+                    reportTermination(results[crashed], limitsFor(crashed), status, usage);
+                    for (const auto& batch : splitIntoBatches(crashed + 1, child.end)) {
+                        pending.push_front(batch);
+                    }
+                }
+                running.erase(running.begin() + c);
+            }
+        }
+        return results;
+    }
+};
+
+// HDR-:   1  highestValue    
+// ,     
+class HdrHistogram {
+private:
+    uint64_t highestValue;
+    int subBucketHalfCountMagnitude;
+    uint64_t subBucketHalfCount;
+    uint64_t subBucketMask;
+    vector<uint64_t> counts;
+    uint64_t totalCount = 0;
+    uint64_t maxValue = 0;
+    long double sum = 0;
+
+    size_t indexOf(uint64_t value) const {
+        int bucket = 63 - __builtin_clzll(value | subBucketMask) - subBucketHalfCountMagnitude;
+        uint64_t subBucket = value >> bucket;
+        return ((size_t)bucket << subBucketHalfCountMagnitude) + subBucket;
+    }
+
+    //  ,     
+    uint64_t highestEquivalent(size_t index) const {
+        int bucket = (int)(index >> subBucketHalfCountMagnitude) - 1;
+        uint64_t subBucket = (index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+        if (bucket < 0) {
+            subBucket -= subBucketHalfCount;
+            bucket = 0;
+        }
+        return (subBucket << bucket) + ((uint64_t)1 << bucket) - 1;
+    }
+
+public:
+    explicit HdrHistogram(uint64_t highest = 3600ULL * 1000 * 1000, int significantDigits = 3) : highestValue(highest) {
+        uint64_t largestWithSingleUnitResolution = 2;
+        for (int i = 0; i < significantDigits; i++) {
+            largestWithSingleUnitResolution *= 10;
+        }
+        int subBucketCountMagnitude = 64 - __builtin_clzll(largestWithSingleUnitResolution - 1);
+        subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+        subBucketHalfCount = (uint64_t)1 << subBucketHalfCountMagnitude;
+        subBucketMask = ((uint64_t)1 << subBucketCountMagnitude) - 1;
+        counts.assign(indexOf(highestValue) + 1, 0);
+    }
+
+    void record(uint64_t value) {
+        value = max<uint64_t>(1, min(value, highestValue));
+        counts[indexOf(value)]++;
+        totalCount++;
+        maxValue = max(maxValue, value);
+        sum += value;
+    }
+
+    void merge(const HdrHistogram& other) {
+        for (size_t i = 0; i < counts.size() && i < other.counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        totalCount += other.totalCount;
+        maxValue = max(maxValue, other.maxValue);
+        sum += other.sum;
+    }
+
+    uint64_t valueAtPercentile(double percentile) const {
+        uint64_t target = max<uint64_t>(1, (uint64_t)ceil(percentile / 100.0 * totalCount));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                return min(highestEquivalent(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    uint64_t getTotalCount() const {
+        return totalCount;
+    }
+
+    uint64_t getMax() const {
+        return maxValue;
+    }
+
+    double getMean() const {
+        return totalCount ? (double)(sum / totalCount) : 0;
+    }
+
+    void print(ostream& out, const string& unit) const {
+        for (double percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+            out << "  p" << percentile << ": " << valueAtPercentile(percentile) << " " << unit << endl;
+        }
+        out << "  max: " << maxValue << " " << unit << ", mean: " << getMean() << " " << unit << endl;
+    }
+};
+
+//   
+struct LoadReport {
+    HdrHistogram latency;      //   , 
+    HdrHistogram serviceTime;  //   , 
+    size_t requests = 0;
+    size_t passed = 0;
+    double targetRate = 0;
+    double achievedRate = 0;
+
+    void print(ostream& out) const {
+        out << "Requests: " << requests << ", passed: " << passed << endl;
+        out << "Target rate: " << targetRate << "/s, achieved: " << achievedRate << "/s" << endl;
+        out << "Latency (corrected for coordinated omission):" << endl;
+        latency.print(out, "us");
+        out << "Service time:" << endl;
+        serviceTime.print(out, "us");
+    }
+};
+
+//   :       
+// ,   "  ".    
+//  ,       
+class LoadGenerator {
+private:
+    vector<TestSuite::ScheduledTest> schedule;
+    const TestSuite& suite;
+    double requestsPerSecond;
+    chrono::microseconds duration;
+    unsigned threadCount;
+
+public:
+    LoadGenerator(const TestSuite& testSuite, double rate, chrono::microseconds runDuration,
+                  unsigned threads = thread::hardware_concurrency())
+        : schedule(testSuite.getSchedule()), suite(testSuite), requestsPerSecond(rate), duration(runDuration),
+          threadCount(max(1u, threads)) {}
+
+    LoadReport run() const {
+        LoadReport report;
+        report.targetRate = requestsPerSecond;
+        if (schedule.empty() || requestsPerSecond <= 0) {
+            return report;
+        }
+        size_t total = (size_t)(requestsPerSecond * duration.count() / 1e6);
+
+        FixtureStack processFixtures;
+        suite.setUpProcessFixtures(processFixtures);
+
+        vector<HdrHistogram> latencies(threadCount), serviceTimes(threadCount);
+        vector<size_t> passed(threadCount, 0);
+        atomic<size_t> next(0);
+        auto start = chrono::steady_clock::now() + chrono::milliseconds(1);
+        auto worker = [&](unsigned t) {
+            FixtureStack threadFixtures;
+            for (size_t i = next++; i < total; i = next++) {
+                auto scheduled = start + chrono::nanoseconds((long long)(i * 1e9 / requestsPerSecond));
+                this_thread::sleep_until(scheduled);
+                auto began = chrono::steady_clock::now();
+                bool ok = false;
+                try {
+                    ok = TestSuite::runScheduled(schedule[i % schedule.size()], processFixtures, threadFixtures);
+                } catch (const bad_alloc&) {
+                }
+                auto finished = chrono::steady_clock::now();
+                passed[t] += ok;
+                latencies[t].record(chrono::duration_cast<chrono::microseconds>(finished - scheduled).count());
+                serviceTimes[t].record(chrono::duration_cast<chrono::microseconds>(finished - began).count());
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        for (unsigned t = 0; t < threadCount; t++) {
+            report.latency.merge(latencies[t]);
+            report.serviceTime.merge(serviceTimes[t]);
+            report.passed += passed[t];
+        }
+        report.requests = total;
+        report.achievedRate = elapsed > 0 ? total / elapsed : 0;
+        return report;
+    }
+};
+
+//       
+struct PassRateEstimate {
+    double passRate = 0;
+    double lowerBound = 0;
+    double upperBound = 0;
+    size_t sampled = 0;
+    size_t population = 0;
+};
+
+//  :  -  ,   
+//   ( ).    k   
+//   (bottom-k),    , 
+//    k   -     
+class StratifiedSampler {
+private:
+    struct Stratum {
+        size_t population = 0;
+        size_t sampled = 0;
+        size_t passed = 0;
+    };
+
+    const TestSuite& suite;
+    uint64_t seed;
+    double z;
+    map<string, Stratum> strata;
+    unordered_map<size_t, bool> results;  //   ->  
+
+    static string stratumOf(const TestCaseBase& test) {
+        size_t size = test.inputView().size() + test.expectedView().size();
+        int sizeBucket = 0;
+        while (size >>= 1) {
+            sizeBucket++;
+        }
+        return string(typeid(test.getRunner()).name()) + "/" + to_string(test.getRunner().getComplexityLevel()) +
+               "/" + to_string(sizeBucket);
+    }
+
+    uint64_t keyOf(size_t index) const {
+        return hashBytes(string_view((const char*)&index, sizeof(index))) ^ seed;
+    }
+
+    //  :    - ceil(fraction * N)    
+    void drawAndRun(double fraction) {
+        map<string, priority_queue<pair<uint64_t, size_t>>> reservoirs;
+        const auto& tests = suite.getTests();
+        for (size_t i = 0; i < tests.size(); i++) {
+            string name = stratumOf(*tests[i]);
+            size_t capacity = max<size_t>(1, (size_t)ceil(fraction * strata[name].population));
+            auto& reservoir = reservoirs[name];
+            uint64_t key = keyOf(i);
+            if (reservoir.size() < capacity) {
+                reservoir.emplace(key, i);
+            } else if (key < reservoir.top().first) {
+                reservoir.pop();
+                reservoir.emplace(key, i);
+            }
+        }
+        for (auto& entry : reservoirs) {
+            Stratum& stratum = strata[entry.first];
+            for (auto& reservoir = entry.second; !reservoir.empty(); reservoir.pop()) {
+                size_t index = reservoir.top().second;
+                if (results.count(index)) {
+                    continue;
+                }
+                bool passed = false;
+                try {
+                    passed = tests[index]->runTest();
+                } catch (const exception&) {
+                }
+                results[index] = passed;
+                stratum.sampled++;
+                stratum.passed += passed;
+            }
+        }
+    }
+
+    PassRateEstimate estimate() const {
+        PassRateEstimate result;
+        double variance = 0;
+        for (const auto& entry : strata) {
+            const Stratum& stratum = entry.second;
+            result.population += stratum.population;
+        }
+        for (const auto& entry : strata) {
+            const Stratum& stratum = entry.second;
+            if (stratum.sampled == 0) {
+                continue;
+            }
+            double weight = (double)stratum.population / result.population;
+            double rate = (double)stratum.passed / stratum.sampled;
+            //        0  100%  
+            double smoothed = (stratum.passed + 1.0) / (stratum.sampled + 2.0);
+            double finiteCorrection = 1.0 - (double)stratum.sampled / stratum.population;
+            result.passRate += weight * rate;
+            result.sampled += stratum.sampled;
+            variance += weight * weight * finiteCorrection * smoothed * (1 - smoothed) / stratum.sampled;
+        }
+        double halfWidth = z * sqrt(variance);
+        result.lowerBound = max(0.0, result.passRate - halfWidth);
+        result.upperBound = min(1.0, result.passRate + halfWidth);
+        return result;
+    }
+
+public:
+    // z = 1.96  95%  
+    StratifiedSampler(const TestSuite& testSuite, uint64_t randomSeed = 0x9e3779b97f4a7c15ULL, double zScore = 1.96)
+        : suite(testSuite), seed(randomSeed), z(zScore) {
+        for (const auto& test : suite.getTests()) {
+            strata[stratumOf(*test)].population++;
+        }
+    }
+
+    PassRateEstimate sample(double fraction) {
+        drawAndRun(fraction);
+        return estimate();
+    }
+
+    //   ,     targetHalfWidth.
+    //  0 < initialFraction <= maxFraction <= 1,      maxFraction
+    PassRateEstimate sampleUntil(double targetHalfWidth, double initialFraction = 0.01, double maxFraction = 1.0) {
+        if (!(initialFraction > 0) || !(initialFraction <= maxFraction) || !(maxFraction <= 1)) {
+            throw invalid_argument("StratifiedSampler: need 0 < initialFraction <= maxFraction <= 1");
+        }
+        PassRateEstimate result;
+        for (double fraction = initialFraction;; fraction = min(maxFraction, fraction * 2)) {
+            result = sample(fraction);
+            if ((result.upperBound - result.lowerBound) / 2 <= targetHalfWidth || fraction >= maxFraction) {
+                return result;
+            }
+        }
+    }
+
+    size_t getStratumCount() const {
+        return strata.size();
+    }
+};
+
+//   
+struct RunResultRow {
+    string testId;
+    uint32_t runId;
+    TestOutcome outcome;
+    uint32_t durationMicros;
+    uint64_t memoryBytes;
+};
+
+//    ,  .  
+//   ;   : testId 
+// , runId  outcome - RLE,  runId, testId  
+//  min/max (),      .
+//          
+class ResultsStore {
+private:
+    static constexpr size_t BLOCK_ROWS = 1 << 16;
+
+    template <class T>
+    struct RunLength {
+        T value;
+        uint32_t count;
+    };
+
+    struct Block {
+        vector<uint32_t> testCodes;
+        vector<RunLength<uint32_t>> runIds;
+        vector<RunLength<uint8_t>> outcomes;
+        vector<uint32_t> durations;
+        vector<uint64_t> memory;
+        uint32_t minRun = UINT32_MAX, maxRun = 0;
+        uint32_t minTest = UINT32_MAX, maxTest = 0;
+        uint32_t minDuration = UINT32_MAX, maxDuration = 0;
+
+        size_t rowCount() const {
+            return testCodes.size();
+        }
+    };
+
+    //   ,   
+    struct Row {
+        uint32_t testCode;
+        uint32_t runId;
+        TestOutcome outcome;
+        uint32_t durationMicros;
+        uint64_t memoryBytes;
+    };
+
+    string path;
+    unordered_map<string, uint32_t> dictionary;
+    vector<string> testIds;
+    vector<Block> sealed;
+    Block open;
+    vector<uint32_t> runIds;  //  runId  
+    unsigned threadCount;
+
+    template <class T>
+    static void appendRunLength(vector<RunLength<T>>& column, T value) {
+        if (!column.empty() && column.back().value == value) {
+            column.back().count++;
+        } else {
+            column.push_back({value, 1});
+        }
+    }
+
+    template <class T>
+    static bool writeVector(FILE* file, const vector<T>& values) {
+        uint64_t count = values.size();
+        return fwrite(&count, sizeof(count), 1, file) == 1 &&
+               (count == 0 || fwrite(values.data(), sizeof(T), count, file) == count);
+    }
+
+    //    ;      
+    // ,       
+    template <class Writer>
+    void appendToFile(const string& suffix, Writer write) {
+        string filePath = path + suffix;
+        FILE* file = fopen(filePath.c_str(), "ab");
+        if (!file) {
+            throw runtime_error("ResultsStore: cannot write " + filePath);
+        }
+        long previousSize = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+        bool ok = previousSize >= 0 && write(file);
+        ok = fclose(file) == 0 && ok;
+        if (!ok) {
+            if (previousSize >= 0 && truncate(filePath.c_str(), previousSize) != 0) {
+                throw runtime_error("ResultsStore: cannot write or roll back " + filePath);
+            }
+            throw runtime_error("ResultsStore: cannot write " + filePath);
+        }
+    }
+
+    template <class T>
+    static bool readVector(FILE* file, vector<T>& values) {
+        uint64_t count = 0;
+        if (fread(&count, sizeof(count), 1, file) != 1) {
+            return false;
+        }
+        values.resize(count);
+        return fread(values.data(), sizeof(T), count, file) == count;
+    }
+
+    void persistBlock(const Block& block) {
+        if (path.empty()) {
+            return;
+        }
+        appendToFile(".blocks", [&block](FILE* file) {
+            return writeVector(file, block.testCodes) && writeVector(file, block.runIds) &&
+                   writeVector(file, block.outcomes) && writeVector(file, block.durations) &&
+                   writeVector(file, block.memory);
+        });
+    }
+
+    void persistTestId(const string& testId) {
+        if (path.empty()) {
+            return;
+        }
+        appendToFile(".dict", [&testId](FILE* file) {
+            uint32_t length = testId.size();
+            return fwrite(&length, sizeof(length), 1, file) == 1 &&
+                   (length == 0 || fwrite(testId.data(), 1, length, file) == length);
+        });
+    }
+
+    void load() {
+        if (FILE* file = fopen((path + ".dict").c_str(), "rb")) {
+            uint32_t length = 0;
+            while (fread(&length, sizeof(length), 1, file) == 1) {
+                string testId(length, '\0');
+                if (fread(&testId[0], 1, length, file) != length) {
+                    break;
+                }
+                dictionary[testId] = testIds.size();
+                testIds.push_back(testId);
+            }
+            fclose(file);
+        }
+        if (FILE* file = fopen((path + ".blocks").c_str(), "rb")) {
+            Block block;
+            while (readVector(file, block.testCodes) && readVector(file, block.runIds) && readVector(file, block.outcomes) &&
+                   readVector(file, block.durations) && readVector(file, block.memory)) {
+                if (!isConsistent(block)) {
+                    fclose(file);
+                    throw runtime_error("ResultsStore: corrupt block in " + path);
+                }
+                computeZones(block);
+                for (const auto& run : block.runIds) {
+                    noteRun(run.value);
+                }
+                sealed.push_back(move(block));
+                block = Block();
+            }
+            fclose(file);
+        }
+    }
+
+    //     ,        
+    bool isConsistent(const Block& block) const {
+        size_t rows = block.rowCount();
+        if (block.durations.size() != rows || block.memory.size() != rows) {
+            return false;
+        }
+        for (uint32_t code : block.testCodes) {
+            if (code >= testIds.size()) {
+                return false;
+            }
+        }
+        size_t runRows = 0, outcomeRows = 0;
+        for (const auto& run : block.runIds) {
+            runRows += run.count;
+        }
+        for (const auto& outcome : block.outcomes) {
+            outcomeRows += outcome.count;
+        }
+        return runRows == rows && outcomeRows == rows;
+    }
+
+    static void computeZones(Block& block) {
+        for (const auto& run : block.runIds) {
+            block.minRun = min(block.minRun, run.value);
+            block.maxRun = max(block.maxRun, run.value);
+        }
+        for (uint32_t code : block.testCodes) {
+            block.minTest = min(block.minTest, code);
+            block.maxTest = max(block.maxTest, code);
+        }
+        for (uint32_t duration : block.durations) {
+            block.minDuration = min(block.minDuration, duration);
+            block.maxDuration = max(block.maxDuration, duration);
+        }
+    }
+
+    void noteRun(uint32_t runId) {
+        auto it = lower_bound(runIds.begin(), runIds.end(), runId);
+        if (it == runIds.end() || *it != runId) {
+            runIds.insert(it, runId);
+        }
+    }
+
+    void seal() {
+        if (open.rowCount() == 0) {
+            return;
+        }
+        persistBlock(open);  //        
+        sealed.push_back(move(open));
+        open = Block();
+    }
+
+    template <class Visitor>
+    static void forEachRow(const Block& block, Visitor visit) {
+        size_t runIndex = 0, runLeft = block.runIds.empty() ? 0 : block.runIds[0].count;
+        size_t outcomeIndex = 0, outcomeLeft = block.outcomes.empty() ? 0 : block.outcomes[0].count;
+        for (size_t i = 0; i < block.rowCount(); i++) {
+            while (runLeft == 0) {
+                runLeft = block.runIds[++runIndex].count;
+            }
+            while (outcomeLeft == 0) {
+                outcomeLeft = block.outcomes[++outcomeIndex].count;
+            }
+            runLeft--;
+            outcomeLeft--;
+            visit(Row{block.testCodes[i], block.runIds[runIndex].value, (TestOutcome)block.outcomes[outcomeIndex].value,
+                      block.durations[i], block.memory[i]});
+        }
+    }
+
+    //   ,     [minRun, maxRun], testCode
+    // (UINT32_MAX -  )    minDuration; visit 
+    //     
+    template <class Visitor>
+    void scan(uint32_t minRun, uint32_t maxRun, uint32_t testCode, Visitor visit, uint32_t minDuration = 0) const {
+        vector<const Block*> blocks;
+        for (const auto& block : sealed) {
+            blocks.push_back(&block);
+        }
+        blocks.push_back(&open);
+        atomic<size_t> next(0);
+        auto worker = [&](unsigned threadIndex) {
+            for (size_t b = next++; b < blocks.size(); b = next++) {
+                const Block& block = *blocks[b];
+                if (block.rowCount() == 0 || block.maxRun < minRun || block.minRun > maxRun || block.maxDuration < minDuration) {
+                    continue;
+                }
+                if (testCode != UINT32_MAX && (testCode < block.minTest || testCode > block.maxTest)) {
+                    continue;
+                }
+                forEachRow(block, [&](const Row& row) {
+                    if (row.runId >= minRun && row.runId <= maxRun && (testCode == UINT32_MAX || row.testCode == testCode)) {
+                        visit(row, threadIndex);
+                    }
+                });
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    //  runId   lastRuns 
+    uint32_t firstOfLastRuns(size_t lastRuns) const {
+        if (runIds.empty() || lastRuns == 0) {
+            return UINT32_MAX;
+        }
+        return runIds[runIds.size() - min(lastRuns, runIds.size())];
+    }
+
+    static uint32_t median(vector<uint32_t>& values) {
+        nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    }
+
+public:
+    //   -    
+    explicit ResultsStore(const string& storePath = "", unsigned threads = thread::hardware_concurrency())
+        : path(storePath), threadCount(max(1u, threads)) {
+        if (!path.empty()) {
+            load();
+        }
+    }
+
+    //       flush()
+    ~ResultsStore() {
+        try {
+            flush();
+        } catch (const exception&) {
+        }
+    }
+
+    ResultsStore(const ResultsStore&) = delete;
+    ResultsStore& operator=(const ResultsStore&) = delete;
+
+    void append(const RunResultRow& row) {
+        auto it = dictionary.find(row.testId);
+        uint32_t code;
+        if (it == dictionary.end()) {
+            //   :           
+            persistTestId(row.testId);
+            code = testIds.size();
+            dictionary.emplace(row.testId, code);
+            testIds.push_back(row.testId);
+        } else {
+            code = it->second;
+        }
+        open.testCodes.push_back(code);
+        appendRunLength(open.runIds, row.runId);
+        appendRunLength(open.outcomes, (uint8_t)row.outcome);
+        open.durations.push_back(row.durationMicros);
+        open.memory.push_back(row.memoryBytes);
+        open.minRun = min(open.minRun, row.runId);
+        open.maxRun = max(open.maxRun, row.runId);
+        open.minTest = min(open.minTest, code);
+        open.maxTest = max(open.maxTest, code);
+        open.minDuration = min(open.minDuration, row.durationMicros);
+        open.maxDuration = max(open.maxDuration, row.durationMicros);
+        noteRun(row.runId);
+        if (open.rowCount() == BLOCK_ROWS) {
+            seal();
+        }
+    }
+
+    //   ,     
+    void flush() {
+        seal();
+    }
+
+    size_t getRowCount() const {
+        size_t total = open.rowCount();
+        for (const auto& block : sealed) {
+            total += block.rowCount();
+        }
+        return total;
+    }
+
+    size_t getRunCount() const {
+        return runIds.size();
+    }
+
+    //  Passed     lastRuns  (-1,   )
+    double passRate(const string& testId, size_t lastRuns) const {
+        auto it = dictionary.find(testId);
+        if (it == dictionary.end() || runIds.empty()) {
+            return -1;
+        }
+        vector<size_t> passed(threadCount, 0), total(threadCount, 0);
+        scan(firstOfLastRuns(lastRuns), UINT32_MAX, it->second, [&](const Row& row, unsigned t) {
+            passed[t] += row.outcome == TestOutcome::Passed;
+            total[t]++;
+        });
+        size_t passedSum = 0, totalSum = 0;
+        for (unsigned t = 0; t < threadCount; t++) {
+            passedSum += passed[t];
+            totalSum += total[t];
+        }
+        return totalSum ? (double)passedSum / totalSum : -1;
+    }
+
+    // ,       recentRuns 
+    //      factor   baselineRuns   
+    vector<string> testsWithSlowdown(size_t baselineRuns, size_t recentRuns, double factor = 2.0) const {
+        uint32_t recentStart = firstOfLastRuns(recentRuns);
+        uint32_t baselineStart = firstOfLastRuns(recentRuns + baselineRuns);
+        if (recentStart == UINT32_MAX || baselineStart == recentStart) {
+            return {};
+        }
+        using Durations = unordered_map<uint32_t, vector<uint32_t>>;
+        vector<Durations> baseline(threadCount), recent(threadCount);
+        scan(baselineStart, UINT32_MAX, UINT32_MAX, [&](const Row& row, unsigned t) {
+            (row.runId < recentStart ? baseline[t] : recent[t])[row.testCode].push_back(row.durationMicros);
+        });
+        for (unsigned t = 1; t < threadCount; t++) {
+            for (auto& entry : baseline[t]) {
+                auto& target = baseline[0][entry.first];
+                target.insert(target.end(), entry.second.begin(), entry.second.end());
+            }
+            for (auto& entry : recent[t]) {
+                auto& target = recent[0][entry.first];
+                target.insert(target.end(), entry.second.begin(), entry.second.end());
+            }
+        }
+        vector<string> slower;
+        for (auto& entry : recent[0]) {
+            auto it = baseline[0].find(entry.first);
+            if (it == baseline[0].end()) {
+                continue;
+            }
+            if (median(entry.second) >= factor * median(it->second)) {
+                slower.push_back(testIds[entry.first]);
+            }
+        }
+        sort(slower.begin(), slower.end());
+        return slower;
+    }
+
+    // ,       minMicros   lastRuns
+    // ;     
+    vector<string> testsSlowerThan(uint32_t minMicros, size_t lastRuns) const {
+        vector<vector<char>> slow(threadCount, vector<char>(testIds.size(), 0));
+        scan(firstOfLastRuns(lastRuns), UINT32_MAX, UINT32_MAX, [&](const Row& row, unsigned t) {
+            if (row.durationMicros >= minMicros) {
+                slow[t][row.testCode] = 1;
+            }
+        }, minMicros);
+        vector<string> result;
+        for (size_t code = 0; code < testIds.size(); code++) {
+            for (unsigned t = 0; t < threadCount; t++) {
+                if (slow[t][code]) {
+                    result.push_back(testIds[code]);
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+};
+
+//   :       .
+// complexityLevel < 0  SimpleTestRunner,  AdvancedTestCase
+struct CorpusRecord {
+    string input;
+    string expected;
+    int complexityLevel = -1;
+
+    //   ,     (. storedComplexityLevel)
+    static CorpusRecord fromTest(const TestCaseBase& test) {
+        return {string(test.inputView()), string(test.expectedView()), storedComplexityLevel(test.getRunner(), "Corpus")};
+    }
+
+    shared_ptr<TestCaseBase> toTest() const {
+        if (complexityLevel >= 0) {
+            return make_shared<AdvancedTestCase>(input, expected, complexityLevel);
+        }
+        return make_shared<TestCase>(input, expected, make_unique<SimpleTestRunner>());
+    }
+};
+
+//   : [level:int32][len:uint32][input][len:uint32][expected]
+class CorpusWriter {
+private:
+    FILE* file;
+
+    void writeBytes(const void* data, size_t size) {
+        if (size && fwrite(data, 1, size, file) != size) {
+            throw runtime_error("CorpusWriter: write failed");
+        }
+    }
+
+public:
+    explicit CorpusWriter(const string& path) : file(fopen(path.c_str(), "wb")) {
+        if (!file) {
+            throw runtime_error("Cannot create corpus: " + path);
+        }
+    }
+
+    CorpusWriter(const CorpusWriter&) = delete;
+    CorpusWriter& operator=(const CorpusWriter&) = delete;
+
+    ~CorpusWriter() {
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    void write(const CorpusRecord& record) {
+        checkLengths(record);
+        int32_t level = record.complexityLevel;
+        uint32_t inputLength = record.input.size();
+        uint32_t expectedLength = record.expected.size();
+        writeBytes(&level, sizeof(level));
+        writeBytes(&inputLength, sizeof(inputLength));
+        writeBytes(record.input.data(), inputLength);
+        writeBytes(&expectedLength, sizeof(expectedLength));
+        writeBytes(record.expected.data(), expectedLength);
+    }
+
+    //    (. encode)   
+    void writeRaw(const string& encoded) {
+        writeBytes(encoded.data(), encoded.size());
+    }
+
+    //    32-
+    static void checkLengths(const CorpusRecord& record) {
+        if (record.input.size() > UINT32_MAX || record.expected.size() > UINT32_MAX) {
+            throw runtime_error("CorpusWriter: record is too large");
+        }
+    }
+
+    static string encode(const CorpusRecord& record) {
+        checkLengths(record);
+        string encoded;
+        int32_t level = record.complexityLevel;
+        uint32_t inputLength = record.input.size();
+        uint32_t expectedLength = record.expected.size();
+        encoded.append((const char*)&level, sizeof(level));
+        encoded.append((const char*)&inputLength, sizeof(inputLength));
+        encoded += record.input;
+        encoded.append((const char*)&expectedLength, sizeof(expectedLength));
+        encoded += record.expected;
+        return encoded;
+    }
+
+    //    ;  close()  
+    void close() {
+        if (fflush(file) != 0 || fsync(fileno(file)) != 0 || fclose(file) != 0) {
+            file = nullptr;
+            throw runtime_error("CorpusWriter: flush failed");
+        }
+        file = nullptr;
+    }
+
+    //     :     ,
+    //       
+    static void writeSuite(const TestSuite& suite, const string& path) {
+        if (suite.hasFixtureTests()) {
+            throw runtime_error("CorpusWriter: fixture groups cannot be stored in a corpus");
+        }
+        for (const auto& test : suite.getTests()) {
+            storedComplexityLevel(test->getRunner(), "Corpus");
+        }
+        CorpusWriter writer(path);
+        for (const auto& test : suite.getTests()) {
+            writer.write(CorpusRecord::fromTest(*test));
+        }
+        writer.close();
+    }
+};
+
+//   :      
+class CorpusReader {
+private:
+    FILE* file;
+
+    bool readBytes(void* data, size_t size) {
+        return size == 0 || fread(data, 1, size, file) == size;
+    }
+
+    bool readString(string& text) {
+        uint32_t length = 0;
+        if (!readBytes(&length, sizeof(length))) {
+            return false;
+        }
+        text.resize(length);
+        return readBytes(&text[0], length);
+    }
+
+public:
+    explicit CorpusReader(const string& path) : file(fopen(path.c_str(), "rb")) {
+        if (!file) {
+            throw runtime_error("Cannot open corpus: " + path);
+        }
+    }
+
+    CorpusReader(const CorpusReader&) = delete;
+    CorpusReader& operator=(const CorpusReader&) = delete;
+
+    ~CorpusReader() {
+        fclose(file);
+    }
+
+    bool next(CorpusRecord& record) {
+        int32_t level = 0;
+        if (!readBytes(&level, sizeof(level))) {
+            return false;
+        }
+        record.complexityLevel = level;
+        if (!readString(record.input) || !readString(record.expected)) {
+            throw runtime_error("CorpusReader: truncated record");
+        }
+        return true;
+    }
+
+    //  maxCount  ;   -  
+    vector<CorpusRecord> nextChunk(size_t maxCount) {
+        vector<CorpusRecord> chunk;
+        CorpusRecord record;
+        while (chunk.size() < maxCount && next(record)) {
+            chunk.push_back(move(record));
+        }
+        return chunk;
+    }
+
+    static TestSuite readSuite(const string& path) {
+        TestSuite suite;
+        CorpusReader reader(path);
+        CorpusRecord record;
+        while (reader.next(record)) {
+            suite.addTest(record.toTest());
+        }
+        return suite;
+    }
+};
+
+//   : producer    input  ,
+//     expected   .   
+// ,        path.tmp 
+//   ;        
+//  path.   path  
+class GoldenRecorder {
+private:
+    OutputProducer producer;
+    unsigned threadCount;
+    size_t batchSize;
+
+    size_t record(const function<vector<CorpusRecord>()>& nextBatch, const string& path) const {
+        string temporary = path + ".tmp";
+        mutex readLock;
+        size_t batchesRead = 0;
+        mutex lock;
+        condition_variable changed;
+        map<size_t, string> ready;  //   ->  
+        size_t nextToWrite = 0;
+        size_t totalBatches = SIZE_MAX;
+        exception_ptr failure;
+        atomic<size_t> recorded(0);
+        const size_t window = 4 * threadCount;  //     
+
+        auto fail = [&]() {
+            lock_guard<mutex> guard(lock);
+            if (!failure) {
+                failure = current_exception();
+            }
+        };
+        auto produce = [&]() {
+            try {
+                while (true) {
+                    vector<CorpusRecord> batch;
+                    size_t number;
+                    {
+                        lock_guard<mutex> guard(readLock);
+                        batch = nextBatch();
+                        number = batchesRead;
+                        if (!batch.empty()) {
+                            batchesRead++;
+                        }
+                    }
+                    if (batch.empty()) {
+                        lock_guard<mutex> guard(lock);
+                        totalBatches = number;
+                        break;
+                    }
+                    {
+                        unique_lock<mutex> guard(lock);
+                        changed.wait(guard, [&]() { return failure || number < nextToWrite + window; });
+                        if (failure) {
+                            break;
+                        }
+                    }
+                    string encoded;
+                    for (CorpusRecord& entry : batch) {
+                        entry.expected = producer(entry.input);
+                        encoded += CorpusWriter::encode(entry);
+                    }
+                    recorded += batch.size();
+                    {
+                        lock_guard<mutex> guard(lock);
+                        ready.emplace(number, move(encoded));
+                    }
+                    changed.notify_all();
+                }
+            } catch (...) {
+                fail();
+            }
+            changed.notify_all();
+        };
+
+        {
+            CorpusWriter writer(temporary);
+            vector<thread> threads;
+            for (unsigned t = 0; t < threadCount; t++) {
+                threads.emplace_back(produce);
+            }
+            try {
+                while (true) {
+                    string encoded;
+                    {
+                        unique_lock<mutex> guard(lock);
+                        changed.wait(guard, [&]() {
+                            return failure || ready.count(nextToWrite) || nextToWrite == totalBatches;
+                        });
+                        if (failure || nextToWrite == totalBatches) {
+                            break;
+                        }
+                        auto found = ready.find(nextToWrite);
+                        encoded = move(found->second);
+                        ready.erase(found);
+                        nextToWrite++;
+                    }
+                    changed.notify_all();
+                    writer.writeRaw(encoded);
+                }
+                if (!failure) {
+                    writer.close();
+                }
+            } catch (...) {
+                fail();
+            }
+            changed.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        if (!failure && rename(temporary.c_str(), path.c_str()) != 0) {
+            try {
+                throw runtime_error("GoldenRecorder: cannot replace " + path);
+            } catch (...) {
+                failure = current_exception();
+            }
+        }
+        if (failure) {
+            remove(temporary.c_str());
+            rethrow_exception(failure);
+        }
+        return recorded;
+    }
+
+public:
+    GoldenRecorder(OutputProducer producerFunction, unsigned threads = thread::hardware_concurrency(), size_t recordsPerBatch = 256)
+        : producer(move(producerFunction)), threadCount(max(1u, threads)), batchSize(max<size_t>(1, recordsPerBatch)) {}
+
+    //     ;   . , 
+    //     (  ,  ),
+    //    
+    size_t recordSuite(const TestSuite& suite, const string& path) const {
+        if (suite.hasFixtureTests()) {
+            throw runtime_error("GoldenRecorder: fixture groups cannot be recorded");
+        }
+        vector<shared_ptr<TestCaseBase>> tests = suite.getTests();
+        for (const auto& test : tests) {
+            storedComplexityLevel(test->getRunner(), "GoldenRecorder");
+        }
+        size_t position = 0;
+        return record([&]() {
+            vector<CorpusRecord> batch;
+            for (; position < tests.size() && batch.size() < batchSize; position++) {
+                batch.push_back(CorpusRecord::fromTest(*tests[position]));
+            }
+            return batch;
+        }, path);
+    }
+
+    //   ; sourcePath    path
+    size_t recordCorpus(const string& sourcePath, const string& path) const {
+        CorpusReader reader(sourcePath);
+        return record([&]() { return reader.nextChunk(batchSize); }, path);
+    }
+};
+
+//  -: MinHash-   input  expected,
+// LSH-         .
+//     ;     ,
+//      
+class NearDuplicateAnalyzer {
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    size_t bands;
+    size_t rowsPerBand;
+    size_t shingleLength;
+    double threshold;
+    unsigned threadCount;
+    vector<uint32_t> signatures;  //  bands * rowsPerBand   
+
+    size_t signatureLength() const {
+        return bands * rowsPerBand;
+    }
+
+    void computeSignature(const string& input, const string& expected, uint32_t* signature) const {
+        string text = input + '\x1f' + expected;
+        fill(signature, signature + signatureLength(), UINT32_MAX);
+        size_t shingles = text.size() > shingleLength ? text.size() - shingleLength + 1 : 1;
+        for (size_t i = 0; i < shingles; i++) {
+            uint64_t hash = hashBytes(string_view(text).substr(i, shingleLength));
+            // k -     : h_j = a + j * b
+            uint32_t a = (uint32_t)hash;
+            uint32_t b = (uint32_t)(hash >> 32) | 1;
+            for (size_t j = 0; j < signatureLength(); j++) {
+                signature[j] = min(signature[j], (uint32_t)(a + j * b));
+            }
+        }
+    }
+
+    double estimatedSimilarity(size_t a, size_t b) const {
+        const uint32_t* first = &signatures[a * signatureLength()];
+        const uint32_t* second = &signatures[b * signatureLength()];
+        size_t equal = 0;
+        for (size_t j = 0; j < signatureLength(); j++) {
+            equal += first[j] == second[j];
+        }
+        return (double)equal / signatureLength();
+    }
+
+    static size_t findRoot(vector<size_t>& parent, size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+public:
+    NearDuplicateAnalyzer(size_t bandCount = 16, size_t rows = 4, size_t shingle = 5, double similarityThreshold = 0.8,
+                          unsigned threads = thread::hardware_concurrency())
+        : bands(bandCount), rowsPerBand(rows), shingleLength(shingle), threshold(similarityThreshold),
+          threadCount(max(1u, threads)) {}
+
+    void addSuite(const TestSuite& suite) {
+        const auto& tests = suite.getTests();
+        for (size_t begin = 0; begin < tests.size(); begin += CHUNK_SIZE) {
+            vector<CorpusRecord> chunk;
+            for (size_t i = begin; i < min(tests.size(), begin + CHUNK_SIZE); i++) {
+                //     ,    
+                chunk.push_back({string(tests[i]->inputView()), string(tests[i]->expectedView()),
+                                 tests[i]->getRunner().getComplexityLevel()});
+            }
+            addRecords(chunk);
+        }
+    }
+
+    //    
+    void addRecords(const vector<CorpusRecord>& chunk) {
+        size_t first = signatures.size() / signatureLength();
+        signatures.resize(signatures.size() + chunk.size() * signatureLength());
+        atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < chunk.size(); i = next++) {
+                computeSignature(chunk[i].input, chunk[i].expected, &signatures[(first + i) * signatureLength()]);
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    //     CHUNK_SIZE 
+    void addCorpus(const string& path) {
+        CorpusReader reader(path);
+        for (auto chunk = reader.nextChunk(CHUNK_SIZE); !chunk.empty(); chunk = reader.nextChunk(CHUNK_SIZE)) {
+            addRecords(chunk);
+        }
+    }
+
+    size_t getTestCount() const {
+        return signatures.size() / signatureLength();
+    }
+
+    //      ;     
+    vector<vector<size_t>> findClusters() const {
+        size_t count = getTestCount();
+        vector<size_t> parent(count);
+        for (size_t i = 0; i < count; i++) {
+            parent[i] = i;
+        }
+        //   ,     
+        mutex unionLock;
+        atomic<size_t> nextBand(0);
+        auto worker = [&]() {
+            for (size_t band = nextBand++; band < bands; band = nextBand++) {
+                vector<pair<uint64_t, uint32_t>> keys(count);
+                for (size_t i = 0; i < count; i++) {
+                    const char* rows = (const char*)&signatures[i * signatureLength() + band * rowsPerBand];
+                    keys[i] = {hashBytes(string_view(rows, rowsPerBand * sizeof(uint32_t))), (uint32_t)i};
+                }
+                sort(keys.begin(), keys.end());
+                for (size_t start = 0, i = 1; i <= count; i++) {
+                    if (i < count && keys[i].first == keys[start].first) {
+                        continue;
+                    }
+                    for (size_t j = start + 1; j < i; j++) {
+                        if (estimatedSimilarity(keys[start].second, keys[j].second) >= threshold) {
+                            lock_guard<mutex> guard(unionLock);
+                            size_t a = findRoot(parent, keys[start].second);
+                            size_t b = findRoot(parent, keys[j].second);
+                            parent[max(a, b)] = min(a, b);
+                        }
+                    }
+                    start = i;
+                }
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        map<size_t, vector<size_t>> byRoot;
+        for (size_t i = 0; i < count; i++) {
+            byRoot[findRoot(parent, i)].push_back(i);
+        }
+        vector<vector<size_t>> clusters;
+        for (auto& entry : byRoot) {
+            if (entry.second.size() > 1) {
+                clusters.push_back(move(entry.second));
+            }
+        }
+        return clusters;
+    }
+
+    //    -      
+    vector<bool> representativeMask() const {
+        vector<bool> keep(getTestCount(), true);
+        for (const auto& cluster : findClusters()) {
+            for (size_t i = 1; i < cluster.size(); i++) {
+                keep[cluster[i]] = false;
+            }
+        }
+        return keep;
+    }
+
+    //       addSuite
+    TestSuite reduceSuite(const TestSuite& suite) const {
+        vector<bool> keep = representativeMask();
+        TestSuite reduced;
+        for (size_t i = 0; i < suite.getTests().size() && i < keep.size(); i++) {
+            if (keep[i]) {
+                reduced.addTest(suite.getTests()[i]);
+            }
+        }
+        return reduced;
+    }
+
+    //       ,    addCorpus
+    void reduceCorpus(const string& inputPath, const string& outputPath) const {
+        vector<bool> keep = representativeMask();
+        CorpusReader reader(inputPath);
+        CorpusWriter writer(outputPath);
+        CorpusRecord record;
+        for (size_t i = 0; reader.next(record); i++) {
+            if (i >= keep.size() || keep[i]) {
+                writer.write(record);
+            }
+        }
+        writer.close();
+    }
+};
+
+// HyperLogLog:       64- 
+class HyperLogLog {
+private:
+    static constexpr int PRECISION = 14;
+    static constexpr size_t REGISTER_COUNT = 1 << PRECISION;
+
+    vector<uint8_t> registers;
+
+public:
+    HyperLogLog() : registers(REGISTER_COUNT, 0) {}
+
+    void add(uint64_t hash) {
+        size_t index = hash >> (64 - PRECISION);
+        uint64_t rest = (hash << PRECISION) | (1ULL << (PRECISION - 1));
+        registers[index] = max<uint8_t>(registers[index], __builtin_clzll(rest) + 1);
+    }
+
+    void merge(const HyperLogLog& other) {
+        for (size_t i = 0; i < REGISTER_COUNT; i++) {
+            registers[i] = max(registers[i], other.registers[i]);
+        }
+    }
+
+    double estimate() const {
+        double sum = 0;
+        size_t zeros = 0;
+        for (uint8_t value : registers) {
+            sum += ldexp(1.0, -value);
+            zeros += value == 0;
+        }
+        double m = REGISTER_COUNT;
+        double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        if (estimate <= 2.5 * m && zeros > 0) {
+            estimate = m * log(m / zeros);  //     
+        }
+        return estimate;
+    }
+};
+
+//         
+struct CorpusProfile {
+    static constexpr size_t SIZE_BUCKETS = 33;  //  : 0, 1, 2-3, 4-7, ...
+
+    size_t testCount = 0;
+    size_t inputBytes = 0;
+    size_t expectedBytes = 0;
+    size_t compressedBytes = 0;
+    size_t comparedBytes = 0;  // ,    ()
+    vector<size_t> inputSizes = vector<size_t>(SIZE_BUCKETS, 0);
+    vector<size_t> expectedSizes = vector<size_t>(SIZE_BUCKETS, 0);
+    map<string, size_t> runnerTypes;
+    map<int, size_t> complexityLevels;  // -1 -  
+    HyperLogLog distinctTests;
+    double nanosPerCall = 0;
+    double nanosPerByte = 0;
+
+    static size_t sizeBucket(size_t size) {
+        size_t bucket = 0;
+        while (size) {
+            size >>= 1;
+            bucket++;
+        }
+        return min(bucket, SIZE_BUCKETS - 1);
+    }
+
+    void merge(const CorpusProfile& other) {
+        testCount += other.testCount;
+        inputBytes += other.inputBytes;
+        expectedBytes += other.expectedBytes;
+        compressedBytes += other.compressedBytes;
+        comparedBytes += other.comparedBytes;
+        for (size_t i = 0; i < SIZE_BUCKETS; i++) {
+            inputSizes[i] += other.inputSizes[i];
+            expectedSizes[i] += other.expectedSizes[i];
+        }
+        for (const auto& entry : other.runnerTypes) {
+            runnerTypes[entry.first] += entry.second;
+        }
+        for (const auto& entry : other.complexityLevels) {
+            complexityLevels[entry.first] += entry.second;
+        }
+        distinctTests.merge(other.distinctTests);
+    }
+
+    double duplicateRatio() const {
+        return testCount ? max(0.0, 1.0 - min<double>(testCount, distinctTests.estimate()) / testCount) : 0;
+    }
+
+    double compressionRatio() const {
+        return compressedBytes ? (double)(inputBytes + expectedBytes) / compressedBytes : 1;
+    }
+
+    //       
+    // "    +   "
+    double estimatedSeconds() const {
+        return (testCount * nanosPerCall + comparedBytes * nanosPerByte) / 1e9;
+    }
+
+    void print(ostream& out) const {
+        out << "Tests: " << testCount << ", input bytes: " << inputBytes << ", expected bytes: " << expectedBytes << endl;
+        out << "Duplicate ratio: " << duplicateRatio() << ", compression ratio (FSST-style): " << compressionRatio() << endl;
+        out << "Estimated single-thread run time: " << estimatedSeconds() << " s" << endl;
+        out << "Size histogram (bytes <  : input / expected):" << endl;
+        for (size_t i = 0; i < SIZE_BUCKETS; i++) {
+            if (inputSizes[i] || expectedSizes[i]) {
+                out << "  " << (1ULL << i) << " : " << inputSizes[i] << " / " << expectedSizes[i] << endl;
+            }
+        }
+        for (const auto& entry : runnerTypes) {
+            out << "Runner " << entry.first << ": " << entry.second << endl;
+        }
+        for (const auto& entry : complexityLevels) {
+            out << "Complexity level " << entry.first << ": " << entry.second << endl;
+        }
+    }
+};
+
+//  :       
+//  .      ,
+//   ;      
+class CorpusProfiler {
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    // ˸    
+    struct Item {
+        string_view input;
+        string_view expected;
+        string runnerType;
+        int complexityLevel;
+    };
+
+    unsigned threadCount;
+    shared_ptr<const SymbolTable> table;
+    CorpusProfile total;
+
+    void processChunk(const vector<Item>& chunk) {
+        if (!table) {
+            vector<string> sample;
+            for (size_t i = 0; i < chunk.size() && i < 1024; i++) {
+                sample.emplace_back(chunk[i].input);
+                sample.emplace_back(chunk[i].expected);
+            }
+            table = SymbolTable::train(sample);
+        }
+        vector<CorpusProfile> partial(threadCount);
+        atomic<size_t> next(0);
+        auto worker = [&](unsigned t) {
+            CorpusProfile& profile = partial[t];
+            for (size_t i = next++; i < chunk.size(); i = next++) {
+                const Item& item = chunk[i];
+                profile.testCount++;
+                profile.inputBytes += item.input.size();
+                profile.expectedBytes += item.expected.size();
+                profile.compressedBytes += table->encode(string(item.input)).size() + table->encode(string(item.expected)).size();
+                profile.comparedBytes += item.input.size() == item.expected.size() ? item.input.size() : 0;
+                profile.inputSizes[CorpusProfile::sizeBucket(item.input.size())]++;
+                profile.expectedSizes[CorpusProfile::sizeBucket(item.expected.size())]++;
+                profile.runnerTypes[item.runnerType]++;
+                profile.complexityLevels[item.complexityLevel]++;
+                profile.distinctTests.add(hashBytes(item.input) ^ (hashBytes(item.expected) * 31) ^ (uint64_t)item.complexityLevel);
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (const auto& profile : partial) {
+            total.merge(profile);
+        }
+    }
+
+    //        SimpleTestRunner
+    void calibrate() {
+        SimpleTestRunner runner;
+        string small = "calibration", large(1 << 16, 'x');
+        string smallCopy = small, largeCopy = large;
+        const int calls = 200000, largeCalls = 2000;
+        size_t matches = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < calls; i++) {
+            matches += static_cast<const ITestRunner&>(runner).executeTest(small, smallCopy);
+        }
+        auto middle = chrono::steady_clock::now();
+        for (int i = 0; i < largeCalls; i++) {
+            matches += static_cast<const ITestRunner&>(runner).executeTest(large, largeCopy);
+        }
+        auto end = chrono::steady_clock::now();
+        total.nanosPerCall = chrono::duration<double, nano>(middle - start).count() / calls;
+        total.nanosPerByte = chrono::duration<double, nano>(end - middle).count() / largeCalls / large.size();
+        if (matches != (size_t)(calls + largeCalls)) {
+            cerr << "CorpusProfiler: calibration runner returned unexpected results" << endl;
+        }
+    }
+
+public:
+    explicit CorpusProfiler(unsigned threads = thread::hardware_concurrency()) : threadCount(max(1u, threads)) {}
+
+    CorpusProfile profileSuite(const TestSuite& suite) {
+        total = CorpusProfile();
+        table = nullptr;
+        calibrate();
+        const auto& tests = suite.getTests();
+        for (size_t begin = 0; begin < tests.size(); begin += CHUNK_SIZE) {
+            vector<Item> chunk;
+            for (size_t i = begin; i < min(tests.size(), begin + CHUNK_SIZE); i++) {
+                chunk.push_back({tests[i]->inputView(), tests[i]->expectedView(), typeid(tests[i]->getRunner()).name(),
+                                 tests[i]->getRunner().getComplexityLevel()});
+            }
+            processChunk(chunk);
+        }
+        return total;
+    }
+
+    CorpusProfile profileCorpus(const string& path) {
+        total = CorpusProfile();
+        table = nullptr;
+        calibrate();
+        CorpusReader reader(path);
+        for (auto records = reader.nextChunk(CHUNK_SIZE); !records.empty(); records = reader.nextChunk(CHUNK_SIZE)) {
+            vector<Item> chunk;
+            for (const auto& record : records) {
+                chunk.push_back({record.input, record.expected,
+                                 record.complexityLevel >= 0 ? typeid(AdvancedTestRunner).name() : typeid(SimpleTestRunner).name(),
+                                 record.complexityLevel});
+            }
+            processChunk(chunk);
+        }
+        return total;
+    }
+};
+
+//       
+enum class SuiteKey {
+    Input,
+    Expected,
+    Identity  // input, expected,     
+};
+
+//        ( - input)
+struct GoldenDiff {
+    vector<shared_ptr<TestCaseBase>> added;
+    vector<shared_ptr<TestCaseBase>> removed;
+    vector<pair<shared_ptr<TestCaseBase>, shared_ptr<TestCaseBase>>> changed;  // , ;    
+};
+
+//      : -  
+//  ,    (-   ,
+//   ).      ,
+//  join,    
+class SuiteSetOperations {
+private:
+    struct Key {
+        string_view input;
+        string_view expected;
+        const type_info* runner;
+        int complexityLevel;  // < 0 -    
+
+        bool operator==(const Key& other) const {
+            return input == other.input && expected == other.expected && runner == other.runner &&
+                   complexityLevel == other.complexityLevel;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return hashBytes(key.input) ^ (hashBytes(key.expected) * 0x9e3779b97f4a7c15ULL) ^ (size_t)key.runner ^
+                   ((size_t)(key.complexityLevel + 1) * 0xff51afd7ed558ccdULL);
+        }
+    };
+
+    //    ,   
+    using Partitions = vector<vector<uint32_t>>;
+
+    SuiteKey keyType;
+    unsigned threadCount;
+    size_t partitionCount;
+
+    Key keyOf(const TestCaseBase& test) const {
+        switch (keyType) {
+        case SuiteKey::Input:
+            return {test.inputView(), string_view(), nullptr, -1};
+        case SuiteKey::Expected:
+            return {string_view(), test.expectedView(), nullptr, -1};
+        default: {
+            //         -
+            return {test.inputView(), test.expectedView(), &typeid(test.getRunner()), test.getRunner().getComplexityLevel()};
+        }
+        }
+    }
+
+    template <class Body>
+    void parallelFor(size_t count, Body body) const {
+        atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                body(i);
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    //      ,     
+    Partitions partition(const TestSuite& suite) const {
+        const auto& tests = suite.getTests();
+        size_t slices = threadCount;
+        size_t step = (tests.size() + slices - 1) / slices;
+        vector<Partitions> local(slices, Partitions(partitionCount));
+        parallelFor(slices, [&](size_t slice) {
+            for (size_t i = slice * step; i < min(tests.size(), (slice + 1) * step); i++) {
+                local[slice][KeyHash()(keyOf(*tests[i])) % partitionCount].push_back(i);
+            }
+        });
+        Partitions result(partitionCount);
+        for (size_t p = 0; p < partitionCount; p++) {
+            for (size_t slice = 0; slice < slices; slice++) {
+                result[p].insert(result[p].end(), local[slice][p].begin(), local[slice][p].end());
+            }
+        }
+        return result;
+    }
+
+    //    ; visit(,  ,    )
+    template <class Visitor>
+    void forEachPartition(const TestSuite& left, const TestSuite& right, Visitor visit) const {
+        Partitions leftParts = partition(left);
+        Partitions rightParts = partition(right);
+        parallelFor(partitionCount, [&](size_t p) {
+            unordered_map<Key, vector<uint32_t>, KeyHash> rightByKey;
+            for (uint32_t index : rightParts[p]) {
+                rightByKey[keyOf(*right.getTests()[index])].push_back(index);
+            }
+            visit(p, leftParts[p], rightByKey);
+        });
+    }
+
+    //         -  
+    template <class Selector>
+    TestSuite collect(const TestSuite& left, const TestSuite& right, Selector select) const {
+        vector<vector<shared_ptr<TestCaseBase>>> outputs(partitionCount);
+        forEachPartition(left, right, [&](size_t p, const vector<uint32_t>& leftIndexes,
+                                          const unordered_map<Key, vector<uint32_t>, KeyHash>& rightByKey) {
+            select(leftIndexes, rightByKey, outputs[p]);
+        });
+        TestSuite result;
+        for (const auto& output : outputs) {
+            for (const auto& test : output) {
+                result.addTest(test);
+            }
+        }
+        return result;
+    }
+
+public:
+    SuiteSetOperations(SuiteKey key = SuiteKey::Identity, unsigned threads = thread::hardware_concurrency(), size_t partitions = 64)
+        : keyType(key), threadCount(max(1u, threads)), partitionCount(max<size_t>(1, partitions)) {}
+
+    //      . sink     ,
+    //   ,    
+    void join(const TestSuite& left, const TestSuite& right,
+              const function<void(const shared_ptr<TestCaseBase>&, const shared_ptr<TestCaseBase>&)>& sink) const {
+        mutex sinkLock;
+        forEachPartition(left, right, [&](size_t, const vector<uint32_t>& leftIndexes,
+                                          const unordered_map<Key, vector<uint32_t>, KeyHash>& rightByKey) {
+            vector<pair<uint32_t, uint32_t>> pairs;
+            for (uint32_t index : leftIndexes) {
+                auto it = rightByKey.find(keyOf(*left.getTests()[index]));
+                if (it != rightByKey.end()) {
+                    for (uint32_t match : it->second) {
+                        pairs.emplace_back(index, match);
+                    }
+                }
+            }
+            lock_guard<mutex> guard(sinkLock);
+            for (const auto& entry : pairs) {
+                sink(left.getTests()[entry.first], right.getTests()[entry.second]);
+            }
+        });
+    }
+
+    TestSuite intersection(const TestSuite& left, const TestSuite& right) const {
+        return collect(left, right, [&](const vector<uint32_t>& leftIndexes,
+                                        const unordered_map<Key, vector<uint32_t>, KeyHash>& rightByKey,
+                                        vector<shared_ptr<TestCaseBase>>& output) {
+            unordered_map<Key, bool, KeyHash> emitted;
+            for (uint32_t index : leftIndexes) {
+                Key key = keyOf(*left.getTests()[index]);
+                if (rightByKey.count(key) && emitted.emplace(key, true).second) {
+                    output.push_back(left.getTests()[index]);
+                }
+            }
+        });
+    }
+
+    TestSuite difference(const TestSuite& left, const TestSuite& right) const {
+        return collect(left, right, [&](const vector<uint32_t>& leftIndexes,
+                                        const unordered_map<Key, vector<uint32_t>, KeyHash>& rightByKey,
+                                        vector<shared_ptr<TestCaseBase>>& output) {
+            unordered_map<Key, bool, KeyHash> emitted;
+            for (uint32_t index : leftIndexes) {
+                Key key = keyOf(*left.getTests()[index]);
+                if (!rightByKey.count(key) && emitted.emplace(key, true).second) {
+                    output.push_back(left.getTests()[index]);
+                }
+            }
+        });
+    }
+
+    //        
+    TestSuite unionOf(const TestSuite& left, const TestSuite& right) const {
+        return collect(left, right, [&](const vector<uint32_t>& leftIndexes,
+                                        const unordered_map<Key, vector<uint32_t>, KeyHash>& rightByKey,
+                                        vector<shared_ptr<TestCaseBase>>& output) {
+            unordered_map<Key, bool, KeyHash> emitted;
+            for (uint32_t index : leftIndexes) {
+                if (emitted.emplace(keyOf(*left.getTests()[index]), true).second) {
+                    output.push_back(left.getTests()[index]);
+                }
+            }
+            //  - ,       
+            vector<uint32_t> fromRight;
+            for (const auto& entry : rightByKey) {
+                if (emitted.emplace(entry.first, true).second) {
+                    fromRight.push_back(entry.second.front());
+                }
+            }
+            sort(fromRight.begin(), fromRight.end());
+            for (uint32_t index : fromRight) {
+                output.push_back(right.getTests()[index]);
+            }
+        });
+    }
+
+    //  :    input, changed - input  , expected 
+    static GoldenDiff diffGolden(const TestSuite& oldSuite, const TestSuite& newSuite,
+                                 unsigned threads = thread::hardware_concurrency()) {
+        SuiteSetOperations byInput(SuiteKey::Input, threads);
+        GoldenDiff diff;
+        diff.added = byInput.difference(newSuite, oldSuite).getTests();
+        diff.removed = byInput.difference(oldSuite, newSuite).getTests();
+        byInput.join(oldSuite, newSuite, [&diff](const shared_ptr<TestCaseBase>& before, const shared_ptr<TestCaseBase>& after) {
+            if (before->expectedView() != after->expectedView()) {
+                diff.changed.emplace_back(before, after);
+            }
+        });
+        // join      ;   
+        unordered_map<const TestCaseBase*, size_t> oldPosition, newPosition;
+        for (size_t i = 0; i < oldSuite.getTests().size(); i++) {
+            oldPosition.emplace(oldSuite.getTests()[i].get(), i);
+        }
+        for (size_t i = 0; i < newSuite.getTests().size(); i++) {
+            newPosition.emplace(newSuite.getTests()[i].get(), i);
+        }
+        sort(diff.changed.begin(), diff.changed.end(), [&](const pair<shared_ptr<TestCaseBase>, shared_ptr<TestCaseBase>>& a,
+                                                         const pair<shared_ptr<TestCaseBase>, shared_ptr<TestCaseBase>>& b) {
+            return make_pair(oldPosition[a.first.get()], newPosition[a.second.get()]) <
+                   make_pair(oldPosition[b.first.get()], newPosition[b.second.get()]);
+        });
+        return diff;
+    }
+};
+
+//    : [:uint8][:uint32][]
+enum class WireMessage : uint8_t {
+    Hello = 1,  // worker -> coordinator: [ :uint64]
+    Request,    // worker -> coordinator:    
+    Assign,     // coordinator -> worker: [:uint64][begin:uint32][end:uint32]
+    Result,     // worker -> coordinator: [:uint64][  ]
+    Heartbeat,  // worker -> coordinator
+    Done,       // coordinator -> worker:   
+    Reject      // coordinator -> worker:   
+};
+
+// TCP-,   WireMessage.  
+// (    ),  -   
+class WireChannel {
+private:
+    static constexpr size_t HEADER_SIZE = 5;
+
+    int fd;
+    mutex writeLock;
+    string incoming;
+
+public:
+    explicit WireChannel(int socketFd) : fd(socketFd) {
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    WireChannel(const WireChannel&) = delete;
+    WireChannel& operator=(const WireChannel&) = delete;
+
+    ~WireChannel() {
+        close(fd);
+    }
+
+    static unique_ptr<WireChannel> connectTo(const string& host, uint16_t port) {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &addresses) != 0) {
+            throw runtime_error("Cannot resolve coordinator: " + host);
+        }
+        int fd = -1;
+        for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+            fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(addresses);
+        if (fd < 0) {
+            throw runtime_error("Cannot connect to coordinator: " + host + ":" + to_string(port));
+        }
+        return make_unique<WireChannel>(fd);
+    }
+
+    int getFd() const {
+        return fd;
+    }
+
+    void send(WireMessage type, const string& payload = string()) {
+        string frame(1, (char)type);
+        uint32_t length = payload.size();
+        frame.append((const char*)&length, sizeof(length));
+        frame += payload;
+        lock_guard<mutex> guard(writeLock);
+        for (size_t sent = 0; sent < frame.size();) {
+            ssize_t count = ::send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                throw runtime_error("WireChannel: connection lost");
+            }
+            sent += count;
+        }
+    }
+
+    //      (  poll); false -  
+    bool fill() {
+        char buffer[65536];
+        ssize_t count = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        incoming.append(buffer, count);
+        return count > 0;
+    }
+
+    //    ,   
+    bool extract(WireMessage& type, string& payload) {
+        if (incoming.size() < HEADER_SIZE) {
+            return false;
+        }
+        uint32_t length;
+        memcpy(&length, incoming.data() + 1, sizeof(length));
+        if (incoming.size() < HEADER_SIZE + length) {
+            return false;
+        }
+        type = (WireMessage)incoming[0];
+        payload.assign(incoming, HEADER_SIZE, length);
+        incoming.erase(0, HEADER_SIZE + length);
+        return true;
+    }
+
+    //   ; false -  
+    bool receive(WireMessage& type, string& payload) {
+        while (!extract(type, payload)) {
+            char buffer[65536];
+            ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            incoming.append(buffer, count);
+        }
+        return true;
+    }
+};
+
+//   .      
+// ;  worker        
+//       .    , 
+// worker      .  worker', 
+//   heartbeatTimeout   (  ),
+//    .     ,
+//     .  
+//   (TestSuite::getSchedule),    
+class DistributedCoordinator {
+private:
+    struct Connection {
+        unique_ptr<WireChannel> channel;
+        bool accepted = false;  //  Hello   
+        chrono::steady_clock::time_point lastSeen;
+        deque<size_t> backlog;
+        set<size_t> inFlight;
+        size_t pendingRequests = 0;
+    };
+
+    const TestSuite& suite;
+    uint64_t suiteFingerprint;
+    size_t batchSize;
+    chrono::milliseconds heartbeatTimeout;
+    int listenFd;
+    uint16_t port;
+    size_t stolenBatches = 0;
+    size_t reassignedBatches = 0;
+
+public:
+    //  :   worker'           
+    static uint64_t fingerprint(const TestSuite& suite) {
+        string digest;
+        for (const auto& entry : suite.getSchedule()) {
+            uint64_t hashes[2] = {hashBytes(entry.test->inputView()),
+                                  hashBytes(entry.test->expectedView()) ^ (entry.group ? hashBytes(entry.group->getName()) : 0)};
+            digest.append((const char*)hashes, sizeof(hashes));
+        }
+        return hashBytes(digest);
+    }
+
+    // port = 0 -   (. getPort)
+    DistributedCoordinator(const TestSuite& testSuite, uint16_t listenPort = 0, size_t testsPerBatch = 256,
+                           chrono::milliseconds timeout = chrono::milliseconds(3000))
+        : suite(testSuite), suiteFingerprint(fingerprint(testSuite)), batchSize(max<size_t>(1, testsPerBatch)),
+          heartbeatTimeout(timeout), listenFd(socket(AF_INET, SOCK_STREAM, 0)), port(0) {
+        if (listenFd < 0) {
+            throw runtime_error("Cannot create coordinator socket");
+        }
+        int enable = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(listenPort);
+        socklen_t length = sizeof(address);
+        if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, 64) != 0 ||
+            getsockname(listenFd, (sockaddr*)&address, &length) != 0) {
+            close(listenFd);
+            throw runtime_error("Cannot listen on port " + to_string(listenPort));
+        }
+        port = ntohs(address.sin_port);
+    }
+
+    DistributedCoordinator(const DistributedCoordinator&) = delete;
+    DistributedCoordinator& operator=(const DistributedCoordinator&) = delete;
+
+    ~DistributedCoordinator() {
+        close(listenFd);
+    }
+
+    uint16_t getPort() const {
+        return port;
+    }
+
+    size_t getStolenBatches() const {
+        return stolenBatches;
+    }
+
+    size_t getReassignedBatches() const {
+        return reassignedBatches;
+    }
+
+    //  worker'   ,      .
+    // onResult        
+    vector<TestResult> run(const function<void(const TestResult&)>& onResult = nullptr) {
+        vector<TestSuite::ScheduledTest> schedule = suite.getSchedule();
+        size_t batchCount = (schedule.size() + batchSize - 1) / batchSize;
+        deque<size_t> pool;
+        for (size_t batch = 0; batch < batchCount; batch++) {
+            pool.push_back(batch);
+        }
+        vector<char> batchDone(batchCount, 0);
+        vector<char> passed(schedule.size(), 0);
+        size_t remaining = batchCount;
+        map<int, Connection> connections;
+
+        auto drop = [&](int fd) {
+            Connection& connection = connections[fd];
+            for (size_t batch : connection.inFlight) {
+                if (!batchDone[batch]) {
+                    pool.push_front(batch);
+                    reassignedBatches++;
+                }
+            }
+            pool.insert(pool.end(), connection.backlog.begin(), connection.backlog.end());
+            connections.erase(fd);
+        };
+
+        auto nextBatchFor = [&](Connection& connection) -> size_t {
+            while (true) {
+                if (connection.backlog.empty()) {
+                    if (!pool.empty()) {
+                        size_t active = 0;
+                        for (const auto& other : connections) {
+                            active += other.second.accepted;
+                        }
+                        size_t share = max<size_t>(1, pool.size() / max<size_t>(1, active));
+                        for (size_t i = 0; i < share; i++) {
+                            connection.backlog.push_back(pool.front());
+                            pool.pop_front();
+                        }
+                    } else {
+                        Connection* victim = nullptr;
+                        for (auto& other : connections) {
+                            if (&other.second != &connection &&
+                                (!victim || other.second.backlog.size() > victim->backlog.size())) {
+                                victim = &other.second;
+                            }
+                        }
+                        if (!victim || victim->backlog.empty()) {
+                            return SIZE_MAX;
+                        }
+                        size_t stolen = (victim->backlog.size() + 1) / 2;
+                        for (size_t i = 0; i < stolen; i++) {
+                            connection.backlog.push_front(victim->backlog.back());
+                            victim->backlog.pop_back();
+                        }
+                        stolenBatches += stolen;
+                    }
+                }
+                size_t batch = connection.backlog.front();
+                connection.backlog.pop_front();
+                if (!batchDone[batch]) {
+                    return batch;
+                }
+            }
+        };
+
+        auto handle = [&](Connection& connection, WireMessage type, const string& payload) {
+            connection.lastSeen = chrono::steady_clock::now();
+            if (type == WireMessage::Hello) {
+                uint64_t workerFingerprint = 0;
+                if (payload.size() == sizeof(workerFingerprint)) {
+                    memcpy(&workerFingerprint, payload.data(), sizeof(workerFingerprint));
+                }
+                if (workerFingerprint != suiteFingerprint) {
+                    connection.channel->send(WireMessage::Reject);
+                    return false;
+                }
+                connection.accepted = true;
+            } else if (!connection.accepted) {
+                return false;
+            } else if (type == WireMessage::Request) {
+                connection.pendingRequests++;
+            } else if (type == WireMessage::Result) {
+                uint64_t batch;
+                if (payload.size() < sizeof(batch)) {
+                    return false;
+                }
+                memcpy(&batch, payload.data(), sizeof(batch));
+                if (!connection.inFlight.erase(batch) || batchDone[batch]) {
+                    return true;
+                }
+                size_t begin = batch * batchSize;
+                size_t end = min(schedule.size(), begin + batchSize);
+                if (payload.size() < sizeof(batch) + (end - begin + 7) / 8) {
+                    return false;
+                }
+                const char* bits = payload.data() + sizeof(batch);
+                for (size_t i = begin; i < end; i++) {
+                    passed[i] = (bits[(i - begin) / 8] >> ((i - begin) % 8)) & 1;
+                    if (onResult) {
+                        onResult({schedule[i].test, passed[i] != 0});
+                    }
+                }
+                batchDone[batch] = 1;
+                remaining--;
+            }
+            return true;
+        };
+
+        while (remaining > 0) {
+            vector<pollfd> polled = {{listenFd, POLLIN, 0}};
+            for (const auto& connection : connections) {
+                polled.push_back({connection.first, POLLIN, 0});
+            }
+            poll(polled.data(), polled.size(), max<long>(1, heartbeatTimeout.count() / 4));
+            auto now = chrono::steady_clock::now();
+
+            if (polled[0].revents & POLLIN) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd >= 0) {
+                    connections[fd].channel = make_unique<WireChannel>(fd);
+                    connections[fd].lastSeen = now;
+                }
+            }
+            vector<int> lost;
+            for (size_t i = 1; i < polled.size(); i++) {
+                Connection& connection = connections[polled[i].fd];
+                bool alive = true;
+                if (polled[i].revents) {
+                    try {
+                        alive = connection.channel->fill();
+                        WireMessage type;
+                        string payload;
+                        while (alive && connection.channel->extract(type, payload)) {
+                            alive = handle(connection, type, payload);
+                        }
+                    } catch (const runtime_error&) {
+                        alive = false;
+                    }
+                }
+                if (!alive || now - connection.lastSeen > heartbeatTimeout) {
+                    lost.push_back(polled[i].fd);
+                }
+            }
+            for (int fd : lost) {
+                drop(fd);
+            }
+
+            for (auto& entry : connections) {
+                Connection& connection = entry.second;
+                while (connection.accepted && connection.pendingRequests > 0) {
+                    size_t batch = nextBatchFor(connection);
+                    if (batch == SIZE_MAX) {
+                        break;
+                    }
+                    string payload((const char*)&batch, sizeof(uint64_t));
+                    uint32_t range[2] = {(uint32_t)(batch * batchSize), (uint32_t)min(schedule.size(), (batch + 1) * batchSize)};
+                    payload.append((const char*)range, sizeof(range));
+                    try {
+                        connection.channel->send(WireMessage::Assign, payload);
+                    } catch (const runtime_error&) {
+                        connection.backlog.push_front(batch);
+                        break;  //      
+                    }
+                    connection.inFlight.insert(batch);
+                    connection.pendingRequests--;
+                }
+            }
+        }
+        //      ,   
+        pollfd pending = {listenFd, POLLIN, 0};
+        while (poll(&pending, 1, 0) > 0 && (pending.revents & POLLIN)) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                break;
+            }
+            connections[fd].channel = make_unique<WireChannel>(fd);
+        }
+        for (auto& entry : connections) {
+            try {
+                entry.second.channel->send(WireMessage::Done);
+            } catch (const runtime_error&) {
+            }
+        }
+
+        vector<TestResult> results;
+        for (size_t i = 0; i < schedule.size(); i++) {
+            results.push_back({schedule[i].test, passed[i] != 0});
+        }
+        return results;
+    }
+};
+
+// Worker  :    ,   ,
+//     threadCount    
+class DistributedWorker {
+private:
+    static constexpr int PREFETCH = 2;  //    
+
+    const TestSuite& suite;
+    string host;
+    uint16_t port;
+    unsigned threadCount;
+    chrono::milliseconds heartbeatInterval;
+
+    string runBatch(const vector<TestSuite::ScheduledTest>& schedule, const FixtureStack& processFixtures,
+                    size_t begin, size_t end) const {
+        vector<char> passed(end - begin, 0);
+        atomic<size_t> next(begin);
+        //      (. TestSuite::runScheduled),
+        //          worker'
+        auto worker = [&]() {
+            FixtureStack threadFixtures;
+            for (size_t i = next++; i < end; i = next++) {
+                try {
+                    passed[i - begin] = TestSuite::runScheduled(schedule[i], processFixtures, threadFixtures);
+                } catch (const bad_alloc&) {
+                    passed[i - begin] = 0;
+                }
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < min<size_t>(threadCount, end - begin); t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+        string bits((passed.size() + 7) / 8, 0);
+        for (size_t i = 0; i < passed.size(); i++) {
+            bits[i / 8] |= (char)(passed[i] << (i % 8));
+        }
+        return bits;
+    }
+
+public:
+    DistributedWorker(const TestSuite& testSuite, const string& coordinatorHost, uint16_t coordinatorPort,
+                      unsigned threads = 1, chrono::milliseconds interval = chrono::milliseconds(500))
+        : suite(testSuite), host(coordinatorHost), port(coordinatorPort), threadCount(max(1u, threads)),
+          heartbeatInterval(interval) {}
+
+    //    Done;    
+    size_t run() {
+        unique_ptr<WireChannel> channel = WireChannel::connectTo(host, port);
+        uint64_t suiteFingerprint = DistributedCoordinator::fingerprint(suite);
+        vector<TestSuite::ScheduledTest> schedule = suite.getSchedule();
+        FixtureStack processFixtures;
+        suite.setUpProcessFixtures(processFixtures);
+        try {
+            channel->send(WireMessage::Hello, string((const char*)&suiteFingerprint, sizeof(suiteFingerprint)));
+            for (int i = 0; i < PREFETCH; i++) {
+                channel->send(WireMessage::Request);
+            }
+        } catch (const runtime_error&) {
+            //       Done -    
+        }
+
+        mutex stopLock;
+        condition_variable stopChanged;
+        bool stopping = false;
+        thread heartbeat([&]() {
+            unique_lock<mutex> guard(stopLock);
+            while (!stopChanged.wait_for(guard, heartbeatInterval, [&]() { return stopping; })) {
+                try {
+                    channel->send(WireMessage::Heartbeat);
+                } catch (const runtime_error&) {
+                    return;
+                }
+            }
+        });
+        auto stopHeartbeat = [&]() {
+            {
+                lock_guard<mutex> guard(stopLock);
+                stopping = true;
+            }
+            stopChanged.notify_all();
+            heartbeat.join();
+        };
+
+        size_t executed = 0;
+        try {
+            WireMessage type;
+            string payload;
+            while (true) {
+                if (!channel->receive(type, payload)) {
+                    throw runtime_error("DistributedWorker: coordinator connection lost");
+                }
+                if (type == WireMessage::Done) {
+                    break;
+                }
+                if (type == WireMessage::Reject) {
+                    throw runtime_error("DistributedWorker: coordinator has a different suite");
+                }
+                if (type != WireMessage::Assign || payload.size() != sizeof(uint64_t) + 2 * sizeof(uint32_t)) {
+                    continue;
+                }
+                uint64_t batch;
+                uint32_t range[2];
+                memcpy(&batch, payload.data(), sizeof(batch));
+                memcpy(range, payload.data() + sizeof(batch), sizeof(range));
+                if (range[0] > range[1] || range[1] > schedule.size()) {
+                    throw runtime_error("DistributedWorker: batch out of range");
+                }
+                string result((const char*)&batch, sizeof(batch));
+                result += runBatch(schedule, processFixtures, range[0], range[1]);
+                channel->send(WireMessage::Result, result);
+                channel->send(WireMessage::Request);
+                executed += range[1] - range[0];
+            }
+        } catch (...) {
+            stopHeartbeat();
+            throw;
+        }
+        stopHeartbeat();
+        return executed;
+    }
+};
+
+//  Task
+class Task {
+private:
+    string description;
+    TestSuite testSuite;
+
+public:
+    Task(const string& desc, const TestSuite& suite)
+        : description(desc), testSuite(suite) {}
+
+    const string& getDescription() const {
+        return description;
+    }
+
+    TestSuite& getTestSuite() {
+        return testSuite;
+    }
+};
+
+//   :     
+class TrainingFixture : public Fixture {
+public:
+    string prefix;
+
+    void setUp() override {
+        prefix = "train:";
+    }
+};
+
+//    PGO- (make pgo):   
+//    TestSuite   
+int runTrainingWorkload() {
+    mt19937 generator(2024);
+    auto randomText = [&generator](size_t length) {
+        string text;
+        for (size_t i = 0; i < length; i++) {
+            text.push_back('a' + generator() % 16);
+        }
+        return text;
+    };
+
+    TestSuite suite;
+    for (int i = 0; i < 200000; i++) {
+        string input = randomText(4 + generator() % 60);
+        string expected = generator() % 4 ? input : randomText(input.size());
+        switch (i % 4) {
+        case 0:
+            suite.addTest(make_shared<TestCase>(input, expected, make_unique<SimpleTestRunner>()));
+            break;
+        case 1:
+            suite.addTest(make_shared<TestCase>(input, expected, make_unique<StaticAdvancedTestRunner<3>>()));
+            break;
+        case 2:
+            suite.addTest(make_shared<TestCase>(input, expected, make_unique<StaticAdvancedTestRunner<1>>()));
+            break;
+        default:
+            if (i % 1000 == 3) {
+                suite.addTest(make_shared<AdvancedTestCase>(input, expected, 1 + i % 5));
+            } else {
+                suite.addTest(make_shared<TestCase>(input, expected, make_unique<SimpleTestRunner>()));
+            }
+        }
+    }
+    auto group = make_shared<FixtureGroup>("training", FixtureScope::PerThread, []() {
+        return make_unique<TrainingFixture>();
+    });
+    for (int i = 0; i < 20000; i++) {
+        string input = randomText(16);
+        group->addTest(make_shared<FixtureTestCase<TrainingFixture>>(input, "train:" + input,
+            [](const TrainingFixture& fixture, const string& text) {
+                return fixture.prefix + text;
+            }));
+    }
+    suite.addFixtureGroup(group);
+
+    size_t passed = 0;
+    for (const auto& result : suite.runAll(thread::hardware_concurrency())) {
+        passed += result.passed;
+    }
+    for (const auto& result : ExecutionPlan(suite.getTests()).run()) {
+        passed += result.passed;
+    }
+    suite.sortTestsByInput();
+    for (int i = 0; i < 200; i++) {
+        if (suite.findTestByExpected(randomText(8))) {
+            passed++;
+        }
+    }
+    suite.enableSubstringIndex();
+    for (int i = 0; i < 2000; i++) {
+        passed += suite.findTestsByInputSubstring(randomText(4)).size();
+    }
+    CompressedTestSuite compressed(suite);
+    for (const auto& test : compressed.getTests()) {
+        passed += test.runTest();
+    }
+    PersistentTestSuite versions = PersistentTestSuite::fromTestSuite(suite);
+    for (int i = 0; i < 10000; i++) {
+        versions = versions.moveTest(generator() % versions.getTestCount(), generator() % versions.getTestCount());
+    }
+    cerr << "Training workload done, checks passed: " << passed << endl;
+    return 0;
+}
+
+//      (laba8 --selftest):  
+//       .    
+// ,    ;   -  
+class SelfTest {
+private:
+    string directory;
+    size_t checks = 0;
+    size_t failures = 0;
+
+    static void removeTree(const string& path) {
+        if (DIR* dir = opendir(path.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                string name = entry->d_name;
+                if (name != "." && name != "..") {
+                    removeTree(path + "/" + name);
+                }
+            }
+            closedir(dir);
+            rmdir(path.c_str());
+        } else {
+            unlink(path.c_str());
+        }
+    }
+
+public:
+    SelfTest() {
+        char pattern[] = "/tmp/laba8-selftest-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            throw runtime_error("SelfTest: cannot create a temporary directory");
+        }
+        directory = pattern;
+    }
+
+    SelfTest(const SelfTest&) = delete;
+    SelfTest& operator=(const SelfTest&) = delete;
+
+    ~SelfTest() {
+        removeTree(directory);
+    }
+
+    string path(const string& name) const {
+        return directory + "/" + name;
+    }
+
+    void check(bool condition, const string& what) {
+        checks++;
+        if (!condition) {
+            failures++;
+            cerr << "FAILED: " << what << endl;
+        }
+    }
+
+    template <class Action>
+    void expectThrow(Action action, const string& what) {
+        bool thrown = false;
+        try {
+            action();
+        } catch (const exception&) {
+            thrown = true;
+        }
+        check(thrown, what + " throws");
+    }
+
+    static string readBytes(const string& filePath) {
+        string bytes;
+        if (FILE* file = fopen(filePath.c_str(), "rb")) {
+            char buffer[4096];
+            size_t count;
+            while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                bytes.append(buffer, count);
+            }
+            fclose(file);
+        }
+        return bytes;
+    }
+
+    static void writeBytes(const string& filePath, const string& bytes) {
+        if (FILE* file = fopen(filePath.c_str(), "wb")) {
+            fwrite(bytes.data(), 1, bytes.size(), file);
+            fclose(file);
+        }
+    }
+
+    int finish() const {
+        cerr << "Self-test: " << checks - failures << " of " << checks << " checks passed" << endl;
+        return failures ? 1 : 0;
+    }
+};
+
+//      
+vector<bool> verdictsOf(const TestSuite& suite) {
+    vector<bool> verdicts;
+    for (const auto& test : suite.getTests()) {
+        verdicts.push_back(test->runTest());
+    }
+    return verdicts;
+}
+
+// ,     :   ,
+//    ,     
+TestSuite makeStorableSuite() {
+    TestSuite suite;
+    suite.addTest(make_shared<TestCase>("same", "same", make_unique<SimpleTestRunner>()));
+    suite.addTest(make_shared<TestCase>("left", "right", make_unique<SimpleTestRunner>()));
+    suite.addTest(make_shared<TestCase>("", "", make_unique<SimpleTestRunner>()));
+    suite.addTest(make_shared<TestCase>(string("a\0b", 3), string("a\0b", 3), make_unique<SimpleTestRunner>()));
+    suite.addTest(make_shared<TestCase>("low", "low", make_unique<AdvancedTestRunner>(1)));
+    suite.addTest(make_shared<AdvancedTestCase>("high", "high", 5));
+    return suite;
+}
+
+void selfTestCorpus(SelfTest& test) {
+    TestSuite suite = makeStorableSuite();
+    string path = test.path("suite.corpus");
+    CorpusWriter::writeSuite(suite, path);
+    TestSuite loaded = CorpusReader::readSuite(path);
+    test.check(loaded.getTestCount() == suite.getTestCount(), "corpus keeps the test count");
+    bool sameData = loaded.getTestCount() == suite.getTestCount();
+    for (int i = 0; sameData && i < suite.getTestCount(); i++) {
+        sameData = loaded.getTests()[i]->inputView() == suite.getTests()[i]->inputView() &&
+                   loaded.getTests()[i]->expectedView() == suite.getTests()[i]->expectedView();
+    }
+    test.check(sameData, "corpus keeps input and expected bytes");
+    test.check(verdictsOf(loaded) == verdictsOf(suite), "corpus keeps verdicts");
+
+    TestSuite unstorable = makeStorableSuite();
+    unstorable.addTest(make_shared<TestCase>("x", "x", make_unique<StaticAdvancedTestRunner<1>>()));
+    string rejected = test.path("rejected.corpus");
+    test.expectThrow([&]() { CorpusWriter::writeSuite(unstorable, rejected); }, "corpus with an unstorable runner");
+    test.check(access(rejected.c_str(), F_OK) != 0, "rejected corpus is not created");
+
+    TestSuite withGroup = makeStorableSuite();
+    auto group = make_shared<FixtureGroup>("group", FixtureScope::PerThread, []() { return unique_ptr<Fixture>(); });
+    group->addTest(make_shared<TestCase>("g", "g", make_unique<SimpleTestRunner>()));
+    withGroup.addFixtureGroup(group);
+    test.expectThrow([&]() { CorpusWriter::writeSuite(withGroup, rejected); }, "corpus with fixture groups");
+
+    //   
+    string bytes = SelfTest::readBytes(path);
+    string truncated = test.path("truncated.corpus");
+    SelfTest::writeBytes(truncated, bytes.substr(0, bytes.size() - 2));
+    test.expectThrow([&]() { CorpusReader::readSuite(truncated); }, "truncated corpus");
+    test.expectThrow([&]() { CorpusReader reader(test.path("missing.corpus")); }, "missing corpus");
+}
+
+void selfTestGolden(SelfTest& test) {
+    TestSuite suite;
+    for (int i = 0; i < 1000; i++) {
+        string input = "case" + to_string(i);
+        if (i % 2) {
+            suite.addTest(make_shared<TestCase>(input, "stale", make_unique<SimpleTestRunner>()));
+        } else {
+            suite.addTest(make_shared<TestCase>(input, "stale", make_unique<AdvancedTestRunner>(1 + i % 5)));
+        }
+    }
+    auto producer = [](const string& input) {
+        return "out:" + input;
+    };
+    string path = test.path("golden.corpus");
+    size_t recorded = GoldenRecorder(producer, 4, 7).recordSuite(suite, path);
+    test.check(recorded == 1000, "golden records every test");
+    CorpusReader reader(path);
+    CorpusRecord record;
+    bool ordered = true;
+    size_t count = 0;
+    for (; reader.next(record); count++) {
+        const TestCaseBase& source = *suite.getTests()[count];
+        ordered = ordered && record.input == source.inputView() && record.expected == producer(record.input) &&
+                  record.complexityLevel == source.getRunner().getComplexityLevel();
+    }
+    test.check(ordered && count == 1000, "golden keeps order, producer output and runner levels");
+
+    //  producer'    
+    GoldenRecorder failing([](const string& input) -> string {
+        if (input == "case500") {
+            throw runtime_error("producer failed");
+        }
+        return input;
+    }, 4, 7);
+    test.expectThrow([&]() { failing.recordSuite(suite, path); }, "golden with a failing producer");
+    test.check(CorpusReader::readSuite(path).getTestCount() == 1000, "failed golden run keeps the old file");
+    test.check(access((path + ".tmp").c_str(), F_OK) != 0, "failed golden run removes its temporary file");
+
+    TestSuite unstorable;
+    unstorable.addTest(make_shared<TestCase>("x", "x", make_unique<StaticAdvancedTestRunner<1>>()));
+    test.expectThrow([&]() { GoldenRecorder(producer).recordSuite(unstorable, path); }, "golden with an unstorable runner");
+}
+
+void selfTestResultsStore(SelfTest& test) {
+    string path = test.path("history");
+    {
+        ResultsStore store(path, 2);
+        for (uint32_t run = 1; run <= 4; run++) {
+            for (int id = 0; id < 3; id++) {
+                bool passed = id == 0 || (id == 1 && run % 2 == 0);
+                store.append({"test" + to_string(id), run, passed ? TestOutcome::Passed : TestOutcome::Failed,
+                              100 * run, 0});
+            }
+        }
+        //    
+    }
+    ResultsStore reopened(path, 2);
+    test.check(reopened.getRowCount() == 12 && reopened.getRunCount() == 4, "results store keeps rows and runs");
+    test.check(reopened.passRate("test0", 4) == 1.0 && reopened.passRate("test1", 4) == 0.5 &&
+                   reopened.passRate("test2", 4) == 0.0 && reopened.passRate("test1", 1) == 1.0,
+               "results store keeps outcomes per test and run");
+    test.check(reopened.passRate("unknown", 4) == -1, "results store has no data for unknown tests");
+
+    //    ,    
+    string dictionary = SelfTest::readBytes(path + ".dict");
+    SelfTest::writeBytes(path + ".dict", "");
+    test.expectThrow([&]() { ResultsStore store(path); }, "results store with a truncated dictionary");
+    SelfTest::writeBytes(path + ".dict", dictionary);
+
+    //    
+    string blocks = SelfTest::readBytes(path + ".blocks");
+    uint64_t wrongCount = 1;
+    memcpy(&blocks[0], &wrongCount, sizeof(wrongCount));
+    SelfTest::writeBytes(path + ".blocks", blocks.substr(0, sizeof(wrongCount) + sizeof(uint32_t)) +
+                                                blocks.substr(sizeof(wrongCount) + 12 * sizeof(uint32_t)));
+    test.expectThrow([&]() { ResultsStore store(path); }, "results store with a corrupt block");
+}
+
+void selfTestSuiteImage(SelfTest& test) {
+    TestSuite suite = makeStorableSuite();
+    string path = test.path("suite.image");
+    suite.saveImage(path);
+    {
+        auto image = TestSuite::loadImage(path);
+        bool sameData = image->size() == (size_t)suite.getTestCount();
+        vector<bool> verdicts;
+        for (size_t i = 0; sameData && i < image->size(); i++) {
+            sameData = image->inputView(i) == suite.getTests()[i]->inputView() &&
+                       image->expectedView(i) == suite.getTests()[i]->expectedView() &&
+                       image->getComplexityLevel(i) == suite.getTests()[i]->getRunner().getComplexityLevel();
+            verdicts.push_back(image->runTest(i));
+        }
+        test.check(sameData, "suite image keeps data and runner levels");
+        test.check(verdicts == verdictsOf(suite), "suite image keeps verdicts");
+        test.check(image->findIndexByExpected("right") == 1 && image->findIndexByExpected("same") == 0 &&
+                       image->findIndexByExpected("absent") == SIZE_MAX,
+                   "suite image finds tests by expected");
+        bool sorted = true;
+        for (size_t rank = 1; rank < image->size(); rank++) {
+            sorted = sorted && image->inputView(image->sortedIndex(rank - 1)) <= image->inputView(image->sortedIndex(rank));
+        }
+        test.check(sorted, "suite image keeps the input order");
+    }
+
+    TestSuite unstorable = makeStorableSuite();
+    unstorable.addTest(make_shared<TestCase>("x", "x", make_unique<StaticAdvancedTestRunner<1>>()));
+    string rejected = test.path("rejected.image");
+    test.expectThrow([&]() { unstorable.saveImage(rejected); }, "suite image with an unstorable runner");
+    test.check(access(rejected.c_str(), F_OK) != 0, "rejected suite image is not created");
+
+    string bytes = SelfTest::readBytes(path);
+    string damaged = test.path("damaged.image");
+    SelfTest::writeBytes(damaged, bytes.substr(0, bytes.size() - 1));
+    test.expectThrow([&]() { TestSuite::loadImage(damaged); }, "truncated suite image");
+
+    // indexBuckets ( 48  )    
+    string header = bytes;
+    uint64_t buckets = 3;
+    memcpy(&header[48], &buckets, sizeof(buckets));
+    SelfTest::writeBytes(damaged, header);
+    test.expectThrow([&]() { TestSuite::loadImage(damaged); }, "suite image with a corrupt header");
+
+    //  input     :     
+    string entry = bytes;
+    uint64_t caseTableOffset;
+    memcpy(&caseTableOffset, &entry[24], sizeof(caseTableOffset));
+    uint32_t length = UINT32_MAX;
+    memcpy(&entry[caseTableOffset + 16], &length, sizeof(length));
+    SelfTest::writeBytes(damaged, entry);
+    auto image = TestSuite::loadImage(damaged);
+    test.expectThrow([&]() { image->inputView(0); }, "suite image with a corrupt case entry");
+    test.expectThrow([&]() { TestSuite::loadImage(test.path("missing.image")); }, "missing suite image");
+}
+
+void selfTestBlobStore(SelfTest& test) {
+    string directory = test.path("blobs");
+    string kept, stale, live;
+    {
+        BlobStore store(directory);
+        auto blob = store.put(string("binary\0expected", 15));
+        test.check(blob->view() == string("binary\0expected", 15), "blob store keeps the bytes");
+        test.check(store.put(string("binary\0expected", 15)) == blob && store.get(blob->getId()) == blob,
+                   "blob store maps equal data once");
+        test.check(store.put("")->view().empty(), "blob store keeps empty blobs");
+
+        BlobTestCase blobTest("expected", store.put("expected"), make_unique<SimpleTestRunner>());
+        test.check(blobTest.runTest() && blobTest.expectedView() == "expected", "blob test reads expected from the store");
+
+        kept = blob->getId();
+        live = blobTest.getExpectedBlob()->getId();
+        stale = store.put("stale")->getId();
+        //  kept     live , stale   
+        test.check(store.sweep({live}) == 2, "blob sweep removes unreferenced blobs");
+        test.check(store.get(kept)->view() == string("binary\0expected", 15), "blob sweep keeps mapped blobs");
+        test.expectThrow([&]() { store.get(stale); }, "reading a swept blob");
+    }
+    BlobStore reopened(directory);
+    test.check(reopened.get(live)->view() == "expected", "blob store keeps blobs across instances");
+    test.check(reopened.sweep({}) == 2, "blob sweep removes blobs no one references");
+
+    BlobStore missing(test.path("no/such/directory"));
+    test.expectThrow([&]() { missing.put("data"); }, "blob store in a missing directory");
+}
+
+void selfTestOracleCache(SelfTest& test) {
+    string path = test.path("oracle.cache");
+    auto oracle = [](const string& input) {
+        return "answer:" + input;
+    };
+    {
+        OracleCache cache(oracle, path);
+        for (int i = 0; i < 100; i++) {
+            cache.get("input" + to_string(i));
+        }
+        cache.get("");
+        //   
+    }
+    OracleCache reopened([](const string&) -> string { throw runtime_error("oracle called"); }, path);
+    bool same = reopened.get("") == "answer:";
+    for (int i = 0; same && i < 100; i++) {
+        same = reopened.get("input" + to_string(i)) == oracle("input" + to_string(i));
+    }
+    test.check(same && reopened.getComputations() == 0, "oracle cache keeps answers across runs");
+    test.expectThrow([&]() { reopened.get("new"); }, "oracle failure");
+    test.expectThrow([&]() { reopened.get("new"); }, "oracle retry after a failure");
+    test.check(reopened.getComputations() == 2, "failed oracle answers are not cached");
+
+    //   ,   
+    string bytes = SelfTest::readBytes(path);
+    SelfTest::writeBytes(path, bytes.substr(0, bytes.size() - 1));
+    OracleCache truncated(oracle, path);
+    for (int i = 0; i < 100; i++) {
+        truncated.get("input" + to_string(i));
+    }
+    truncated.get("");
+    test.check(truncated.getComputations() == 1, "oracle cache drops only a truncated last answer");
+
+    string foreign = test.path("foreign.cache");
+    SelfTest::writeBytes(foreign, "not a cache");
+    test.expectThrow([&]() { OracleCache cache(oracle, foreign); }, "oracle cache with a wrong magic");
+}
+
+//       
+struct PrefixFixture : public Fixture {
+    string prefix;
+
+    void setUp() override {
+        prefix = "fixture:";
+    }
+};
+
+class ThrowingTestRunner : public ITestRunner {
+public:
+    bool executeTest(const string&, const string&) const override {
+        throw runtime_error("runner failed");
+    }
+
+    ThrowingTestRunner* clone() const override {
+        return new ThrowingTestRunner(*this);
+    }
+};
+
+void selfTestDistributed(SelfTest& test) {
+    TestSuite suite;
+    unordered_map<const TestCaseBase*, bool> verdicts;
+    auto add = [&](const shared_ptr<TestCaseBase>& testCase, bool passes) {
+        verdicts[testCase.get()] = passes;
+        return testCase;
+    };
+    for (int i = 0; i < 500; i++) {
+        string input = "case" + to_string(i);
+        suite.addTest(add(make_shared<TestCase>(input, i % 3 ? input : "other", make_unique<SimpleTestRunner>()), i % 3 != 0));
+    }
+    suite.addTest(add(make_shared<TestCase>("x", "x", make_unique<ThrowingTestRunner>()), false));
+    auto prefixed = [](const PrefixFixture& fixture, const string& input) {
+        return fixture.prefix + input;
+    };
+    for (FixtureScope scope : {FixtureScope::PerThread, FixtureScope::PerProcess}) {
+        auto group = make_shared<FixtureGroup>(scope == FixtureScope::PerThread ? "thread" : "process", scope,
+                                               []() { return unique_ptr<Fixture>(make_unique<PrefixFixture>()); });
+        for (int i = 0; i < 40; i++) {
+            string input = "g" + to_string(i);
+            group->addTest(add(make_shared<FixtureTestCase<PrefixFixture>>(input, i % 4 ? "fixture:" + input : input, prefixed),
+                               i % 4 != 0));
+        }
+        suite.addFixtureGroup(group);
+    }
+
+    TestSuite other;
+    other.addTest(make_shared<TestCase>("other", "other", make_unique<SimpleTestRunner>()));
+
+    DistributedCoordinator coordinator(suite, 0, 16);
+    vector<TestResult> results;
+    thread coordinating([&]() { results = coordinator.run(); });
+    test.expectThrow([&]() { DistributedWorker(other, "127.0.0.1", coordinator.getPort()).run(); },
+                     "worker with a different suite");
+    size_t executed[2] = {0, 0};
+    thread second([&]() { executed[1] = DistributedWorker(suite, "127.0.0.1", coordinator.getPort(), 2).run(); });
+    executed[0] = DistributedWorker(suite, "127.0.0.1", coordinator.getPort(), 2).run();
+    second.join();
+    coordinating.join();
+
+    vector<TestSuite::ScheduledTest> schedule = suite.getSchedule();
+    bool ordered = results.size() == schedule.size();
+    bool correct = ordered;
+    for (size_t i = 0; ordered && i < results.size(); i++) {
+        ordered = results[i].test == schedule[i].test;
+        correct = correct && results[i].passed == verdicts[results[i].test.get()];
+    }
+    test.check(ordered, "coordinator returns results in schedule order");
+    test.check(correct, "coordinator merges verdicts of groups and throwing runners");
+    test.check(executed[0] + executed[1] >= schedule.size(), "workers execute the whole schedule");
+}
+
+int runSelfTest() {
+    SelfTest test;
+    selfTestCorpus(test);
+    selfTestGolden(test);
+    selfTestResultsStore(test);
+    selfTestSuiteImage(test);
+    selfTestBlobStore(test);
+    selfTestOracleCache(test);
+    selfTestDistributed(test);
+    return test.finish();
+}
+
+//  
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--train") {
+        return runTrainingWorkload();
+    }
+    if (argc > 1 && string(argv[1]) == "--selftest") {
+        return runSelfTest();
+    }
+    //   : laba8 --coordinate <> <>
+    //     laba8 --work <> <> <> []
+    if (argc > 3 && string(argv[1]) == "--coordinate") {
+        TestSuite corpusSuite = CorpusReader::readSuite(argv[2]);
+        DistributedCoordinator coordinator(corpusSuite, stoi(argv[3]));
+        cerr << "Coordinator listening on port " << coordinator.getPort() << endl;
+        size_t passed = 0;
+        vector<TestResult> results = coordinator.run();
+        for (const auto& result : results) {
+            passed += result.passed;
+        }
+        cout << "Passed " << passed << " of " << results.size() << " tests" << endl;
+        return passed == results.size() ? 0 : 1;
+    }
+    if (argc > 4 && string(argv[1]) == "--work") {
+        TestSuite corpusSuite = CorpusReader::readSuite(argv[2]);
+        unsigned threads = argc > 5 ? stoi(argv[5]) : thread::hardware_concurrency();
+        DistributedWorker worker(corpusSuite, argv[3], stoi(argv[4]), threads);
+        try {
+            cerr << "Worker executed " << worker.run() << " tests" << endl;
+        } catch (const runtime_error& error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
     auto test1 = make_shared<TestCase>("input3", "expected3", make_unique<SimpleTestRunner>());
     auto test2 = make_shared<AdvancedTestCase>("input1", "expected1", 5);
     auto test3 = make_shared<AdvancedTestCase>("input2", "expected2", 4);